@@ -0,0 +1,279 @@
+// Headless ScreenCanvas stress benchmark.
+//
+// Populates a canvas with generated images (and optionally copies of a sample video), drives
+// scripted zoom, pan and drag sequences through the regular input paths and reports per-frame
+// timings as JSON. Frame time = pending events (overlay layout, decoder feedback...) + one
+// synchronous viewport repaint. Runs on the offscreen platform unless QT_QPA_PLATFORM is set.
+//
+//   CanvasBenchmark --images 200 --videos 4 --video-file clip.mp4 --frames 300 --output run.json
+
+#include "MainWindow.h"
+#include "ClientInfo.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QGraphicsItem>
+#include <QGraphicsScene>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLinearGradient>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QWheelEvent>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace {
+
+struct Config {
+    int images = 100;
+    int videos = 0;
+    QString videoFile;
+    QSize imageSize{1920, 1080};
+    QSize viewportSize{1600, 1000};
+    int frames = 240;
+    int settleMs = 2000;
+    quint32 seed = 1;
+};
+
+// Distinct but deterministic content so identical hashes do not collapse images into one
+QImage makeImage(const QSize& size, int index, QRandomGenerator& rng)
+{
+    QImage img(size, QImage::Format_RGB32);
+    QPainter p(&img);
+    QLinearGradient g(0, 0, size.width(), size.height());
+    g.setColorAt(0.0, QColor::fromHsv((index * 37) % 360, 180, 220));
+    g.setColorAt(1.0, QColor::fromHsv((index * 37 + 120) % 360, 200, 120));
+    p.fillRect(img.rect(), g);
+    for (int i = 0; i < 40; ++i) {
+        p.setBrush(QColor::fromRgb(rng.generate()));
+        p.setPen(Qt::NoPen);
+        const int w = rng.bounded(size.width() / 8 + 1) + 8;
+        const int h = rng.bounded(size.height() / 8 + 1) + 8;
+        p.drawEllipse(rng.bounded(size.width()), rng.bounded(size.height()), w, h);
+    }
+    p.setPen(Qt::white);
+    p.drawText(img.rect(), Qt::AlignCenter, QString::number(index));
+    return img;
+}
+
+QJsonObject summarize(std::vector<qint64> frameNs, qint64 wallNs)
+{
+    QJsonObject o;
+    o["frames"] = static_cast<int>(frameNs.size());
+    if (frameNs.empty()) return o;
+    std::sort(frameNs.begin(), frameNs.end());
+    auto pct = [&](double p) {
+        const size_t idx = std::min(frameNs.size() - 1, static_cast<size_t>(p * (frameNs.size() - 1) + 0.5));
+        return frameNs[idx] / 1.0e6;
+    };
+    double sum = 0.0;
+    for (qint64 ns : frameNs) sum += ns;
+    o["mean_ms"] = sum / frameNs.size() / 1.0e6;
+    o["p50_ms"] = pct(0.50);
+    o["p90_ms"] = pct(0.90);
+    o["p95_ms"] = pct(0.95);
+    o["p99_ms"] = pct(0.99);
+    o["max_ms"] = frameNs.back() / 1.0e6;
+    o["fps"] = wallNs > 0 ? frameNs.size() * 1.0e9 / wallNs : 0.0;
+    return o;
+}
+
+class Runner {
+public:
+    Runner(ScreenCanvas* canvas, int frames) : m_canvas(canvas), m_frames(frames) {}
+
+    // step(i) feeds input for frame i; the frame is timed until the repaint returned
+    QJsonObject run(const std::function<void(int)>& step)
+    {
+        std::vector<qint64> samples;
+        samples.reserve(m_frames);
+        QElapsedTimer wall;
+        wall.start();
+        for (int i = 0; i < m_frames; ++i) {
+            QElapsedTimer t;
+            t.start();
+            step(i);
+            QCoreApplication::processEvents();
+            m_canvas->viewport()->repaint();
+            samples.push_back(t.nsecsElapsed());
+        }
+        return summarize(std::move(samples), wall.nsecsElapsed());
+    }
+
+private:
+    ScreenCanvas* m_canvas;
+    int m_frames;
+};
+
+void sendWheel(QWidget* target, const QPointF& pos, const QPoint& pixelDelta, Qt::KeyboardModifiers mods)
+{
+    QWheelEvent ev(pos, target->mapToGlobal(pos), pixelDelta, pixelDelta * 2, Qt::NoButton, mods,
+                   Qt::NoScrollPhase, false);
+    QCoreApplication::sendEvent(target, &ev);
+}
+
+void sendMouse(QWidget* target, QEvent::Type type, const QPointF& pos, Qt::MouseButtons buttons)
+{
+    const Qt::MouseButton button = (type == QEvent::MouseMove) ? Qt::NoButton : Qt::LeftButton;
+    QMouseEvent ev(type, pos, target->mapToGlobal(pos), button, buttons, Qt::NoModifier);
+    QCoreApplication::sendEvent(target, &ev);
+}
+
+void settle(int ms)
+{
+    QElapsedTimer t;
+    t.start();
+    while (t.elapsed() < ms) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 16);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("CanvasBenchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Offscreen ScreenCanvas paint benchmark (JSON on stdout)");
+    parser.addHelpOption();
+    QCommandLineOption imagesOpt("images", "Number of generated image items.", "n", "100");
+    QCommandLineOption videosOpt("videos", "Number of video items (copies of --video-file).", "n", "0");
+    QCommandLineOption videoFileOpt("video-file", "Sample video used for video items.", "path");
+    QCommandLineOption imageSizeOpt("image-size", "Generated image size.", "WxH", "1920x1080");
+    QCommandLineOption viewportOpt("viewport", "Canvas size.", "WxH", "1600x1000");
+    QCommandLineOption framesOpt("frames", "Frames per scenario.", "n", "240");
+    QCommandLineOption settleOpt("settle-ms", "Time given to async decodes before measuring.", "ms", "2000");
+    QCommandLineOption seedOpt("seed", "Content generator seed.", "n", "1");
+    QCommandLineOption outputOpt("output", "Write the JSON report to a file instead of stdout.", "path");
+    parser.addOptions({imagesOpt, videosOpt, videoFileOpt, imageSizeOpt, viewportOpt, framesOpt,
+                       settleOpt, seedOpt, outputOpt});
+    parser.process(app);
+
+    auto parseSize = [](const QString& text, const QSize& fallback) {
+        const QStringList parts = text.toLower().split('x');
+        if (parts.size() != 2) return fallback;
+        const QSize s(parts[0].toInt(), parts[1].toInt());
+        return s.isEmpty() ? fallback : s;
+    };
+    Config cfg;
+    cfg.images = std::max(0, parser.value(imagesOpt).toInt());
+    cfg.videos = std::max(0, parser.value(videosOpt).toInt());
+    cfg.videoFile = parser.value(videoFileOpt);
+    cfg.imageSize = parseSize(parser.value(imageSizeOpt), cfg.imageSize);
+    cfg.viewportSize = parseSize(parser.value(viewportOpt), cfg.viewportSize);
+    cfg.frames = std::max(1, parser.value(framesOpt).toInt());
+    cfg.settleMs = std::max(0, parser.value(settleOpt).toInt());
+    cfg.seed = parser.value(seedOpt).toUInt();
+    if (cfg.videos > 0 && !QFileInfo::exists(cfg.videoFile)) {
+        QTextStream(stderr) << "--videos requires an existing --video-file\n";
+        return 2;
+    }
+
+    QTemporaryDir tempDir;
+    if (!tempDir.isValid()) {
+        QTextStream(stderr) << "Cannot create a temporary directory\n";
+        return 1;
+    }
+
+    ScreenCanvas canvas;
+    canvas.resize(cfg.viewportSize);
+    canvas.show();
+    canvas.setScreens({ScreenInfo(0, 1920, 1080, 0, 0, true), ScreenInfo(1, 2560, 1440, 1920, 0, false)});
+
+    QStringList paths;
+    QRandomGenerator rng(cfg.seed);
+    for (int i = 0; i < cfg.images; ++i) {
+        const QString path = QDir(tempDir.path()).filePath(QString("image_%1.png").arg(i, 4, 10, QChar('0')));
+        makeImage(cfg.imageSize, i, rng).save(path);
+        paths << path;
+    }
+    for (int i = 0; i < cfg.videos; ++i) paths << cfg.videoFile;
+
+    QElapsedTimer importTimer;
+    importTimer.start();
+    const QList<QGraphicsItem*> items = canvas.importLocalFiles(paths, canvas.scene()->sceneRect().center());
+    const qint64 importMs = importTimer.elapsed();
+    canvas.fitInView(canvas.scene()->itemsBoundingRect(), Qt::KeepAspectRatio);
+    settle(cfg.settleMs);
+
+    QWidget* vp = canvas.viewport();
+    const QPointF center = QRectF(vp->rect()).center();
+#ifdef Q_OS_MACOS
+    const Qt::KeyboardModifiers zoomMods = Qt::MetaModifier;
+#else
+    const Qt::KeyboardModifiers zoomMods = Qt::ControlModifier;
+#endif
+
+    Runner runner(&canvas, cfg.frames);
+    QJsonObject scenarios;
+    scenarios["idle"] = runner.run([](int) {});
+    // Zoom in and back out around the center, one wheel step per frame
+    scenarios["zoom"] = runner.run([&](int i) {
+        const int dir = (i % 120) < 60 ? 1 : -1;
+        sendWheel(vp, center, QPoint(0, dir * 40), zoomMods);
+    });
+    // Pan along a circle
+    scenarios["pan"] = runner.run([&](int i) {
+        const double a = i * 0.1;
+        sendWheel(vp, center, QPoint(int(std::cos(a) * 30), int(std::sin(a) * 30)), Qt::NoModifier);
+    });
+    // Drag the first item back and forth
+    if (!items.isEmpty()) {
+        QGraphicsItem* target = items.first();
+        QPointF pos = canvas.mapFromScene(target->sceneBoundingRect().center());
+        sendMouse(vp, QEvent::MouseButtonPress, pos, Qt::LeftButton);
+        scenarios["drag"] = runner.run([&](int i) {
+            pos += QPointF((i % 80) < 40 ? 6.0 : -6.0, (i % 40) < 20 ? 3.0 : -3.0);
+            sendMouse(vp, QEvent::MouseMove, pos, Qt::LeftButton);
+        });
+        sendMouse(vp, QEvent::MouseButtonRelease, pos, Qt::NoButton);
+    }
+
+    QJsonObject config;
+    config["images"] = cfg.images;
+    config["videos"] = cfg.videos;
+    config["image_size"] = QString("%1x%2").arg(cfg.imageSize.width()).arg(cfg.imageSize.height());
+    config["viewport"] = QString("%1x%2").arg(cfg.viewportSize.width()).arg(cfg.viewportSize.height());
+    config["frames"] = cfg.frames;
+    config["settle_ms"] = cfg.settleMs;
+    config["seed"] = static_cast<qint64>(cfg.seed);
+
+    QJsonObject report;
+    report["benchmark"] = "canvas";
+    report["qt_version"] = QString::fromLatin1(qVersion());
+    report["platform"] = QGuiApplication::platformName();
+    report["config"] = config;
+    report["items"] = static_cast<int>(items.size());
+    report["import_ms"] = importMs;
+    report["scenarios"] = scenarios;
+
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOpt)) {
+        QFile out(parser.value(outputOpt));
+        if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            QTextStream(stderr) << "Cannot write " << out.fileName() << "\n";
+            return 1;
+        }
+        out.write(json);
+    } else {
+        QTextStream(stdout) << json;
+    }
+    return 0;
+}
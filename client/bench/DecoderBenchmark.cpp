@@ -0,0 +1,374 @@
+// FFmpegVideoDecoder benchmark on synthetic clips.
+//
+// Encodes deterministic test clips with libavcodec (every available codec x resolution x GOP
+// combination, reused across runs from --clip-dir) and drives the decoder through its public
+// API, exactly as the canvas does: time to first frame, unpaced decode throughput, RGB32
+// conversion cost per frame and random-seek latency. Prints a JSON report.
+//
+//   DecoderBenchmark --codecs h264,vp9 --resolutions 1080p,2160p --seconds 6 --seeks 40
+
+#include "FFmpegVideoDecoder.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QRandomGenerator>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QTimer>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+extern "C" {
+#include <libavutil/opt.h>
+}
+
+namespace {
+
+struct CodecSpec {
+    const char* name;
+    AVCodecID id;
+    const char* container;
+};
+
+const CodecSpec kCodecs[] = {
+    {"h264", AV_CODEC_ID_H264, "mp4"},
+    {"hevc", AV_CODEC_ID_HEVC, "mp4"},
+    {"vp9", AV_CODEC_ID_VP9, "webm"},
+};
+
+struct ResolutionSpec {
+    const char* name;
+    int width;
+    int height;
+};
+
+const ResolutionSpec kResolutions[] = {
+    {"720p", 1280, 720},
+    {"1080p", 1920, 1080},
+    {"2160p", 3840, 2160},
+};
+
+constexpr int kFps = 30;
+constexpr int kShortGop = 15;
+constexpr int kLongGop = 300;
+
+// Fast settings: the clips only need to exist, encode quality is irrelevant
+void tuneEncoder(AVCodecContext* ctx, const AVCodec* codec)
+{
+    const QByteArray name(codec->name);
+    if (name == "libx264" || name == "libx265") {
+        av_opt_set(ctx->priv_data, "preset", "ultrafast", 0);
+    } else if (name == "libvpx-vp9") {
+        av_opt_set(ctx->priv_data, "deadline", "realtime", 0);
+        av_opt_set(ctx->priv_data, "cpu-used", "8", 0);
+    }
+}
+
+// Moving diagonal bands and a drifting chroma tint: cheap, deterministic, not trivially compressible
+void fillFrame(AVFrame* frame, int index)
+{
+    for (int y = 0; y < frame->height; ++y) {
+        uint8_t* row = frame->data[0] + y * frame->linesize[0];
+        for (int x = 0; x < frame->width; ++x) {
+            row[x] = static_cast<uint8_t>((x + y * 2 + index * 5) ^ ((x >> 4) * (y >> 4) + index));
+        }
+    }
+    for (int y = 0; y < frame->height / 2; ++y) {
+        uint8_t* u = frame->data[1] + y * frame->linesize[1];
+        uint8_t* v = frame->data[2] + y * frame->linesize[2];
+        for (int x = 0; x < frame->width / 2; ++x) {
+            u[x] = static_cast<uint8_t>(128 + ((x + index) & 63) - 32);
+            v[x] = static_cast<uint8_t>(128 + ((y - index) & 63) - 32);
+        }
+    }
+}
+
+bool writePackets(AVCodecContext* enc, AVFormatContext* fmt, AVStream* stream, AVFrame* frame, AVPacket* pkt)
+{
+    if (avcodec_send_frame(enc, frame) < 0) return false;
+    for (;;) {
+        const int ret = avcodec_receive_packet(enc, pkt);
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) return true;
+        if (ret < 0) return false;
+        av_packet_rescale_ts(pkt, enc->time_base, stream->time_base);
+        pkt->stream_index = stream->index;
+        if (av_interleaved_write_frame(fmt, pkt) < 0) return false;
+    }
+}
+
+// Returns an empty string (and the reason) when the codec has no encoder or encoding fails
+QString encodeClip(const QString& path, const CodecSpec& codecSpec, const ResolutionSpec& res,
+                   int gop, int frames, QString* reason)
+{
+    const AVCodec* codec = avcodec_find_encoder(codecSpec.id);
+    if (!codec) {
+        *reason = QStringLiteral("no encoder");
+        return QString();
+    }
+    AVFormatContext* fmt = nullptr;
+    if (avformat_alloc_output_context2(&fmt, nullptr, codecSpec.container, path.toUtf8().constData()) < 0 || !fmt) {
+        *reason = QStringLiteral("no muxer");
+        return QString();
+    }
+    AVCodecContext* enc = avcodec_alloc_context3(codec);
+    AVStream* stream = avformat_new_stream(fmt, nullptr);
+    AVFrame* frame = av_frame_alloc();
+    AVPacket* pkt = av_packet_alloc();
+    bool ok = enc && stream && frame && pkt;
+    if (ok) {
+        enc->width = res.width;
+        enc->height = res.height;
+        enc->time_base = AVRational{1, kFps};
+        enc->framerate = AVRational{kFps, 1};
+        enc->pix_fmt = AV_PIX_FMT_YUV420P;
+        enc->gop_size = gop;
+        enc->max_b_frames = 2;
+        enc->bit_rate = static_cast<int64_t>(res.width) * res.height * 4;
+        if (fmt->oformat->flags & AVFMT_GLOBALHEADER) enc->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+        tuneEncoder(enc, codec);
+        ok = avcodec_open2(enc, codec, nullptr) >= 0
+            && avcodec_parameters_from_context(stream->codecpar, enc) >= 0;
+        if (!ok) *reason = QStringLiteral("encoder rejected settings");
+    }
+    if (ok) {
+        stream->time_base = enc->time_base;
+        frame->format = enc->pix_fmt;
+        frame->width = enc->width;
+        frame->height = enc->height;
+        ok = av_frame_get_buffer(frame, 0) >= 0
+            && avio_open(&fmt->pb, path.toUtf8().constData(), AVIO_FLAG_WRITE) >= 0
+            && avformat_write_header(fmt, nullptr) >= 0;
+        if (!ok) *reason = QStringLiteral("cannot write file");
+    }
+    for (int i = 0; ok && i < frames; ++i) {
+        ok = av_frame_make_writable(frame) >= 0;
+        if (!ok) break;
+        fillFrame(frame, i);
+        frame->pts = i;
+        ok = writePackets(enc, fmt, stream, frame, pkt);
+    }
+    if (ok) {
+        ok = writePackets(enc, fmt, stream, nullptr, pkt) && av_write_trailer(fmt) >= 0;
+        if (!ok) *reason = QStringLiteral("encode failed");
+    }
+    if (fmt->pb) avio_closep(&fmt->pb);
+    av_packet_free(&pkt);
+    av_frame_free(&frame);
+    avcodec_free_context(&enc);
+    avformat_free_context(fmt);
+    if (!ok) {
+        QFile::remove(path);
+        return QString();
+    }
+    return path;
+}
+
+QJsonObject percentiles(std::vector<double> ms)
+{
+    QJsonObject o;
+    o["count"] = static_cast<int>(ms.size());
+    if (ms.empty()) return o;
+    std::sort(ms.begin(), ms.end());
+    auto pct = [&](double p) {
+        return ms[std::min(ms.size() - 1, static_cast<size_t>(p * (ms.size() - 1) + 0.5))];
+    };
+    o["p50_ms"] = pct(0.50);
+    o["p90_ms"] = pct(0.90);
+    o["p99_ms"] = pct(0.99);
+    o["max_ms"] = ms.back();
+    return o;
+}
+
+// Spins the event loop until done() or the timeout; returns the elapsed time or -1
+double waitFor(const std::function<bool()>& done, int timeoutMs)
+{
+    QElapsedTimer t;
+    t.start();
+    while (!done()) {
+        if (t.elapsed() > timeoutMs) return -1.0;
+        QCoreApplication::processEvents(QEventLoop::AllEvents | QEventLoop::WaitForMoreEvents, 5);
+    }
+    return t.nsecsElapsed() / 1.0e6;
+}
+
+QJsonObject benchmarkClip(const QString& path, int seeks, int timeoutMs, quint32 seed)
+{
+    QJsonObject result;
+    FFmpegVideoDecoder decoder;
+    std::shared_ptr<FrameMailbox> mailbox = decoder.frameMailbox();
+    // Coalesced notification: every delivery must be consumed to get the next one
+    int framesSeen = 0;
+    QObject::connect(&decoder, &FFmpegVideoDecoder::frameAvailable, qApp, [&]() {
+        if (mailbox->consume()) ++framesSeen;
+    }, Qt::QueuedConnection);
+    bool stopped = false;
+    QObject::connect(&decoder, &FFmpegVideoDecoder::playbackStateChanged, qApp,
+                     [&](FFmpegVideoDecoder::PlaybackState s) {
+        stopped = (s == FFmpegVideoDecoder::PlaybackState::Stopped);
+    }, Qt::QueuedConnection);
+
+    // Time to first frame: open + probe + first decode + conversion
+    QElapsedTimer openTimer;
+    openTimer.start();
+    decoder.moveToWorkerThread();
+    decoder.setSource(path);
+    decoder.requestFirstFrame();
+    if (waitFor([&] { return framesSeen > 0; }, timeoutMs) < 0) {
+        result["error"] = QStringLiteral("no first frame");
+        return result;
+    }
+    result["first_frame_ms"] = openTimer.nsecsElapsed() / 1.0e6;
+    const qint64 durationMs = decoder.duration();
+    result["duration_ms"] = durationMs;
+
+    // Random seeks while paused, each until its frame was delivered
+    decoder.pause();
+    waitFor([&] { return decoder.playbackState() == FFmpegVideoDecoder::PlaybackState::Paused; }, timeoutMs);
+    QRandomGenerator rng(seed);
+    std::vector<double> seekMs;
+    int seekTimeouts = 0;
+    for (int i = 0; i < seeks && durationMs > 0; ++i) {
+        const qint64 target = rng.bounded(static_cast<int>(std::max<qint64>(1, durationMs - 100)));
+        mailbox->consume();
+        const int before = framesSeen;
+        decoder.setPosition(target);
+        const double ms = waitFor([&] { return framesSeen > before; }, timeoutMs);
+        if (ms < 0) ++seekTimeouts; else seekMs.push_back(ms);
+    }
+    QJsonObject seek = percentiles(std::move(seekMs));
+    seek["timeouts"] = seekTimeouts;
+    result["seek"] = seek;
+
+    // Throughput: unpaced playback from the start to EOF
+    decoder.setPosition(0);
+    waitFor([&] { return decoder.position() == 0; }, timeoutMs);
+    const quint64 publishedBefore = mailbox->publishedCount();
+    const qint64 conversionBefore = decoder.conversionTimeNs();
+    decoder.setPacingMode(FFmpegVideoDecoder::PacingMode::Unpaced);
+    stopped = false;
+    QElapsedTimer playTimer;
+    playTimer.start();
+    decoder.play();
+    const bool reachedEnd = waitFor([&] { return stopped; }, timeoutMs * 10) >= 0;
+    const double playMs = playTimer.nsecsElapsed() / 1.0e6;
+    const quint64 decoded = mailbox->publishedCount() - publishedBefore;
+    QJsonObject throughput;
+    throughput["frames"] = static_cast<qint64>(decoded);
+    throughput["reached_end"] = reachedEnd;
+    throughput["decode_fps"] = playMs > 0 ? decoded * 1000.0 / playMs : 0.0;
+    throughput["conversion_ms_per_frame"] = decoded > 0
+        ? (decoder.conversionTimeNs() - conversionBefore) / 1.0e6 / decoded : 0.0;
+    // Distributions over the whole run (first frame, seeks and playback)
+    throughput["decode_time"] = decoder.decodeTimeHistogram().summary().toJson();
+    throughput["conversion_time"] = decoder.conversionTimeHistogram().summary().toJson();
+    result["throughput"] = throughput;
+    return result;
+}
+
+QStringList listOption(const QString& value)
+{
+    QStringList out;
+    for (const QString& part : value.split(',', Qt::SkipEmptyParts)) out << part.trimmed().toLower();
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("DecoderBenchmark");
+    // The decoder logs per frame; keep the report readable and the timings honest
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("FFmpegVideoDecoder benchmark on generated clips (JSON on stdout)");
+    parser.addHelpOption();
+    QCommandLineOption codecsOpt("codecs", "Codecs to test.", "list", "h264,hevc,vp9");
+    QCommandLineOption resOpt("resolutions", "Resolutions to test.", "list", "720p,1080p,2160p");
+    QCommandLineOption gopsOpt("gops", "GOP lengths to test (short, long).", "list", "short,long");
+    QCommandLineOption secondsOpt("seconds", "Clip length in seconds.", "s", "10");
+    QCommandLineOption seeksOpt("seeks", "Random seeks per clip.", "n", "30");
+    QCommandLineOption timeoutOpt("timeout-ms", "Timeout for a single operation.", "ms", "5000");
+    QCommandLineOption seedOpt("seed", "Seek position seed.", "n", "1");
+    QCommandLineOption clipDirOpt("clip-dir", "Where generated clips are cached.", "path",
+        QDir(QStandardPaths::writableLocation(QStandardPaths::TempLocation)).filePath("mouffette-bench-clips"));
+    QCommandLineOption outputOpt("output", "Write the JSON report to a file instead of stdout.", "path");
+    parser.addOptions({codecsOpt, resOpt, gopsOpt, secondsOpt, seeksOpt, timeoutOpt, seedOpt, clipDirOpt, outputOpt});
+    parser.process(app);
+
+    const QStringList codecs = listOption(parser.value(codecsOpt));
+    const QStringList resolutions = listOption(parser.value(resOpt));
+    const QStringList gops = listOption(parser.value(gopsOpt));
+    const int seconds = std::max(1, parser.value(secondsOpt).toInt());
+    const int seeks = std::max(0, parser.value(seeksOpt).toInt());
+    const int timeoutMs = std::max(100, parser.value(timeoutOpt).toInt());
+    const quint32 seed = parser.value(seedOpt).toUInt();
+    const QDir clipDir(parser.value(clipDirOpt));
+    if (!QDir().mkpath(clipDir.path())) {
+        QTextStream(stderr) << "Cannot create " << clipDir.path() << "\n";
+        return 1;
+    }
+
+    QJsonArray clips;
+    for (const CodecSpec& codec : kCodecs) {
+        if (!codecs.contains(QLatin1String(codec.name))) continue;
+        for (const ResolutionSpec& res : kResolutions) {
+            if (!resolutions.contains(QLatin1String(res.name))) continue;
+            for (const QString& gopName : gops) {
+                const int gop = (gopName == "long") ? kLongGop : kShortGop;
+                QJsonObject entry;
+                entry["codec"] = codec.name;
+                entry["resolution"] = res.name;
+                entry["gop"] = gop;
+                entry["seconds"] = seconds;
+                const QString path = clipDir.filePath(QString("%1_%2_gop%3_%4s.%5")
+                    .arg(codec.name, res.name).arg(gop).arg(seconds).arg(codec.container));
+                if (!QFileInfo::exists(path)) {
+                    QString reason;
+                    QElapsedTimer encodeTimer;
+                    encodeTimer.start();
+                    if (encodeClip(path, codec, res, gop, seconds * kFps, &reason).isEmpty()) {
+                        entry["skipped"] = reason;
+                        clips.append(entry);
+                        continue;
+                    }
+                    entry["encode_ms"] = encodeTimer.elapsed();
+                }
+                entry["file"] = path;
+                const QJsonObject measured = benchmarkClip(path, seeks, timeoutMs, seed);
+                for (auto it = measured.begin(); it != measured.end(); ++it) entry[it.key()] = it.value();
+                clips.append(entry);
+            }
+        }
+    }
+
+    QJsonObject report;
+    report["benchmark"] = "decoder";
+    report["qt_version"] = QString::fromLatin1(qVersion());
+    report["libavcodec"] = QString::fromLatin1(LIBAVCODEC_IDENT);
+    report["clips"] = clips;
+
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOpt)) {
+        QFile out(parser.value(outputOpt));
+        if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            QTextStream(stderr) << "Cannot write " << out.fileName() << "\n";
+            return 1;
+        }
+        out.write(json);
+    } else {
+        QTextStream(stdout) << json;
+    }
+    return 0;
+}
@@ -0,0 +1,427 @@
+#include "AnimatedImageStore.h"
+#include "Trace.h"
+#include "Log.h"
+#include "MediaMemoryAccountant.h"
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QtEndian>
+#include <algorithm>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/pixdesc.h>
+#include <libswscale/swscale.h>
+}
+
+namespace {
+// Frame delays this short are treated as unset, like browsers do (a 0 delay GIF plays at 10 fps)
+constexpr qint64 kMinFrameDelayMs = 20;
+constexpr qint64 kDefaultFrameDelayMs = 100;
+// Against corrupt or endless streams
+constexpr int kMaxFrames = 10000;
+
+enum class DecodeResult { Ok, Unsupported, TooLarge };
+
+struct DecodedFrames {
+    QVector<QImage> frames;
+    QVector<qint64> delaysMs;
+    bool alpha = false;
+    bool reduced = false;
+    qint64 bytes = 0;
+
+    // false once maxBytes is exceeded
+    bool append(QImage frame, qint64 delayMs, qint64 maxBytes)
+    {
+        bytes += frame.sizeInBytes();
+        if (bytes > maxBytes) return false;
+        frames.append(std::move(frame));
+        delaysMs.append(delayMs <= kMinFrameDelayMs / 2 ? kDefaultFrameDelayMs : std::max(delayMs, kMinFrameDelayMs));
+        return true;
+    }
+};
+
+// Formats with an alpha channel (GIF decodes to ARGB) are often fully opaque anyway
+bool hasTransparentPixels(const QImage& image)
+{
+    if (!image.hasAlphaChannel()) return false;
+    const QImage argb = image.format() == QImage::Format_ARGB32 ? image : image.convertToFormat(QImage::Format_ARGB32);
+    for (int y = 0; y < argb.height(); ++y) {
+        const QRgb* line = reinterpret_cast<const QRgb*>(argb.constScanLine(y));
+        for (int x = 0; x < argb.width(); ++x) {
+            if (qAlpha(line[x]) != 0xFF) return true;
+        }
+    }
+    return false;
+}
+
+QSize fitWithin(const QSize& native, const QSize& maxSize, bool* reduced)
+{
+    *reduced = maxSize.isValid() && (native.width() > maxSize.width() || native.height() > maxSize.height());
+    if (!*reduced) return native;
+    const QSize fitted = native.scaled(maxSize, Qt::KeepAspectRatio);
+    return QSize(std::max(1, fitted.width()), std::max(1, fitted.height()));
+}
+
+struct FFmpegDecodeState {
+    AVFormatContext* format = nullptr;
+    AVCodecContext* codec = nullptr;
+    AVFrame* frame = nullptr;
+    AVPacket* packet = nullptr;
+    SwsContext* sws = nullptr;
+    ~FFmpegDecodeState()
+    {
+        sws_freeContext(sws);
+        av_packet_free(&packet);
+        av_frame_free(&frame);
+        avcodec_free_context(&codec);
+        avformat_close_input(&format);
+    }
+};
+
+// GIF and APNG decoders composite disposal/blending themselves: every frame is a full image
+DecodeResult decodeWithFFmpeg(const QString& path, const QSize& maxSize, qint64 maxBytes, DecodedFrames& out)
+{
+    FFmpegDecodeState s;
+    if (avformat_open_input(&s.format, path.toUtf8().constData(), nullptr, nullptr) != 0) return DecodeResult::Unsupported;
+    if (avformat_find_stream_info(s.format, nullptr) < 0) return DecodeResult::Unsupported;
+    const int streamIndex = av_find_best_stream(s.format, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (streamIndex < 0) return DecodeResult::Unsupported;
+    AVStream* stream = s.format->streams[streamIndex];
+    const AVCodec* codec = avcodec_find_decoder(stream->codecpar->codec_id);
+    if (!codec) return DecodeResult::Unsupported;
+    s.codec = avcodec_alloc_context3(codec);
+    if (!s.codec || avcodec_parameters_to_context(s.codec, stream->codecpar) < 0) return DecodeResult::Unsupported;
+    // Many animations decode at once on the import pool: one thread each
+    s.codec->thread_count = 1;
+    if (avcodec_open2(s.codec, codec, nullptr) < 0) return DecodeResult::Unsupported;
+    s.frame = av_frame_alloc();
+    s.packet = av_packet_alloc();
+    if (!s.frame || !s.packet || s.codec->width <= 0 || s.codec->height <= 0) return DecodeResult::Unsupported;
+
+    const QSize target = fitWithin(QSize(s.codec->width, s.codec->height), maxSize, &out.reduced);
+    QImage pending;
+    qint64 pendingStartMs = -1;
+    qint64 pendingDurationMs = 0;
+    qint64 nextStartMs = 0;
+
+    // A frame is appended once the next one tells how long it lasts
+    auto flushPending = [&](qint64 endMs) {
+        if (pending.isNull()) return true;
+        const qint64 delay = endMs > pendingStartMs ? endMs - pendingStartMs : pendingDurationMs;
+        return out.append(std::move(pending), delay, maxBytes);
+    };
+    auto receiveFrames = [&]() {
+        while (avcodec_receive_frame(s.codec, s.frame) == 0) {
+            const auto format = static_cast<AVPixelFormat>(s.frame->format);
+            s.sws = sws_getCachedContext(s.sws, s.frame->width, s.frame->height, format,
+                                         target.width(), target.height(), AV_PIX_FMT_RGB32,
+                                         SWS_BILINEAR, nullptr, nullptr, nullptr);
+            if (!s.sws) return false;
+            const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(format);
+            const bool alpha = desc && (desc->flags & (AV_PIX_FMT_FLAG_ALPHA | AV_PIX_FMT_FLAG_PAL));
+            // AV_PIX_FMT_RGB32 is native-endian 0xAARRGGBB with straight alpha: QImage::Format_ARGB32
+            QImage image(target, alpha ? QImage::Format_ARGB32 : QImage::Format_RGB32);
+            if (image.isNull()) return false;
+            uint8_t* dstData[4] = { image.bits(), nullptr, nullptr, nullptr };
+            int dstLinesize[4] = { static_cast<int>(image.bytesPerLine()), 0, 0, 0 };
+            if (sws_scale(s.sws, s.frame->data, s.frame->linesize, 0, s.frame->height, dstData, dstLinesize) < 0) return false;
+            if (alpha) {
+                if (!out.alpha) out.alpha = hasTransparentPixels(image);
+                image.convertTo(QImage::Format_ARGB32_Premultiplied);
+            }
+
+            int64_t ts = s.frame->best_effort_timestamp;
+            if (ts == AV_NOPTS_VALUE) ts = s.frame->pts;
+            const qint64 startMs = ts != AV_NOPTS_VALUE ? av_rescale_q(ts, stream->time_base, AVRational{1, 1000}) : nextStartMs;
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 30, 100)
+            const int64_t duration = s.frame->duration;
+#else
+            const int64_t duration = s.frame->pkt_duration;
+#endif
+            if (!flushPending(startMs)) return false;
+            pending = std::move(image);
+            pendingStartMs = startMs;
+            pendingDurationMs = duration > 0 ? av_rescale_q(duration, stream->time_base, AVRational{1, 1000}) : 0;
+            nextStartMs = startMs + std::max(pendingDurationMs, kDefaultFrameDelayMs);
+            av_frame_unref(s.frame);
+            if (out.frames.size() >= kMaxFrames) return false;
+        }
+        return true;
+    };
+
+    bool ok = true;
+    while (ok && av_read_frame(s.format, s.packet) >= 0) {
+        if (s.packet->stream_index == streamIndex && avcodec_send_packet(s.codec, s.packet) >= 0) ok = receiveFrames();
+        av_packet_unref(s.packet);
+    }
+    if (ok) {
+        avcodec_send_packet(s.codec, nullptr);
+        ok = receiveFrames();
+    }
+    if (ok) ok = flushPending(-1);
+    if (out.bytes > maxBytes) return DecodeResult::TooLarge;
+    return out.frames.isEmpty() ? DecodeResult::Unsupported : DecodeResult::Ok;
+}
+
+DecodeResult decodeWithQt(const QString& path, const QSize& maxSize, qint64 maxBytes, DecodedFrames& out)
+{
+    QImageReader reader(path);
+    const QSize full = reader.size();
+    if (full.isValid()) {
+        const QSize target = fitWithin(full, maxSize, &out.reduced);
+        if (out.reduced) reader.setScaledSize(target);
+    }
+    QImage image;
+    while (out.frames.size() < kMaxFrames && reader.read(&image)) {
+        const qint64 delay = reader.nextImageDelay();
+        if (image.hasAlphaChannel()) {
+            if (!out.alpha) out.alpha = hasTransparentPixels(image);
+            image.convertTo(QImage::Format_ARGB32_Premultiplied);
+        } else {
+            image.convertTo(QImage::Format_RGB32);
+        }
+        if (!out.append(std::move(image), delay, maxBytes)) return DecodeResult::TooLarge;
+    }
+    return out.frames.isEmpty() ? DecodeResult::Unsupported : DecodeResult::Ok;
+}
+
+// Frames of `size` (fit in maxEdgePx) that fit in maxBytes; counting further is pointless
+int frameBudget(const QSize& size, qint64 maxBytes, int maxEdgePx)
+{
+    if (maxBytes <= 0 || size.isEmpty()) return kMaxFrames;
+    QSize cached = size;
+    if (maxEdgePx > 0 && std::max(cached.width(), cached.height()) > maxEdgePx) {
+        cached = cached.scaled(maxEdgePx, maxEdgePx, Qt::KeepAspectRatio);
+    }
+    const qint64 frameBytes = std::max<qint64>(1, static_cast<qint64>(cached.width()) * cached.height() * 4);
+    // At least one, so an animation too large for any frame still counts as animated
+    return static_cast<int>(std::clamp<qint64>(maxBytes / frameBytes, 1, kMaxFrames));
+}
+
+void probePng(QFile& file, AnimatedImageStore::Info& info)
+{
+    // Chunks up to the first IDAT: IHDR has the size, acTL (animation control) the frame count
+    file.seek(8);
+    uchar header[8];
+    while (file.read(reinterpret_cast<char*>(header), 8) == 8) {
+        const quint32 length = qFromBigEndian<quint32>(header);
+        const QByteArray type(reinterpret_cast<const char*>(header + 4), 4);
+        if (type == "IDAT") break;
+        if (type == "IHDR" || type == "acTL") {
+            uchar data[8];
+            if (length < 8 || file.read(reinterpret_cast<char*>(data), 8) != 8) break;
+            if (type == "IHDR") {
+                info.size = QSize(static_cast<int>(qFromBigEndian<quint32>(data)), static_cast<int>(qFromBigEndian<quint32>(data + 4)));
+                info.frameCount = 1;
+            } else {
+                info.frameCount = static_cast<int>(std::min<quint32>(qFromBigEndian<quint32>(data), kMaxFrames));
+            }
+            if (!file.seek(file.pos() + length - 8 + 4)) break;
+        } else if (!file.seek(file.pos() + qint64(length) + 4)) {
+            break;
+        }
+    }
+}
+
+void probeWebp(QFile& file, AnimatedImageStore::Info& info, qint64 maxBytes, int maxEdgePx)
+{
+    // RIFF chunks after "RIFF<size>WEBP": VP8X has the canvas size and the animation flag,
+    // each frame is an ANMF chunk
+    file.seek(12);
+    uchar header[8];
+    bool animated = false;
+    int limit = kMaxFrames;
+    while (file.read(reinterpret_cast<char*>(header), 8) == 8 && info.frameCount <= limit) {
+        const quint32 length = qFromLittleEndian<quint32>(header + 4);
+        const QByteArray type(reinterpret_cast<const char*>(header), 4);
+        if (type == "VP8X") {
+            uchar data[10];
+            if (length < 10 || file.read(reinterpret_cast<char*>(data), 10) != 10) break;
+            animated = (data[0] & 0x02) != 0;
+            const auto le24 = [](const uchar* p) { return int(p[0]) | (int(p[1]) << 8) | (int(p[2]) << 16); };
+            info.size = QSize(le24(data + 4) + 1, le24(data + 7) + 1);
+            limit = frameBudget(info.size, maxBytes, maxEdgePx);
+            if (!animated) break;
+            if (!file.seek(file.pos() + (length + (length & 1)) - 10)) break;
+            continue;
+        }
+        if (type == "ANMF") ++info.frameCount;
+        else if (type == "VP8 " || type == "VP8L") break; // still image
+        if (!file.seek(file.pos() + length + (length & 1))) break;
+    }
+    if (!animated) info.frameCount = 1;
+}
+
+// Data sub-blocks (length byte, then data) up to the empty terminator
+bool skipGifSubBlocks(QFile& file)
+{
+    char length = 0;
+    while (file.getChar(&length)) {
+        if (length == 0) return true;
+        if (!file.seek(file.pos() + static_cast<uchar>(length))) return false;
+    }
+    return false;
+}
+
+void probeGif(QFile& file, AnimatedImageStore::Info& info, qint64 maxBytes, int maxEdgePx)
+{
+    // Block walk: count image descriptors, skipping color tables and the LZW data without
+    // decoding it. Unlike QImageReader::imageCount(), which walks the whole file, this stops
+    // once the count is past the budget.
+    uchar screen[7];
+    file.seek(6);
+    if (file.read(reinterpret_cast<char*>(screen), 7) != 7) return;
+    info.size = QSize(qFromLittleEndian<quint16>(screen), qFromLittleEndian<quint16>(screen + 2));
+    const auto colorTableBytes = [](uchar packed) { return (packed & 0x80) ? 3 << ((packed & 0x07) + 1) : 0; };
+    if (!file.seek(file.pos() + colorTableBytes(screen[4]))) return;
+    const int limit = frameBudget(info.size, maxBytes, maxEdgePx);
+    char block = 0;
+    while (info.frameCount <= limit && file.getChar(&block)) {
+        if (block == 0x2C) {
+            // Image descriptor: position, size, flags; then the LZW code size and the data
+            uchar descriptor[9];
+            if (file.read(reinterpret_cast<char*>(descriptor), 9) != 9) break;
+            ++info.frameCount;
+            if (!file.seek(file.pos() + colorTableBytes(descriptor[8]) + 1) || !skipGifSubBlocks(file)) break;
+        } else if (block == 0x21) {
+            // Extension: label, then sub-blocks
+            if (!file.getChar(&block) || !skipGifSubBlocks(file)) break;
+        } else {
+            break; // trailer (0x3B) or garbage
+        }
+    }
+}
+} // namespace
+
+qint64 AnimatedImage::bytes() const
+{
+    qint64 total = 0;
+    for (const QImage& frame : m_frames) total += frame.sizeInBytes();
+    return total;
+}
+
+int AnimatedImage::frameIndexAt(qint64 timeMs) const
+{
+    const qint64 loop = loopDurationMs();
+    if (m_frames.size() < 2 || loop <= 0) return 0;
+    const qint64 t = std::max<qint64>(0, timeMs) % loop;
+    const auto it = std::upper_bound(m_endMs.cbegin(), m_endMs.cend(), t);
+    return std::min(static_cast<int>(it - m_endMs.cbegin()), static_cast<int>(m_frames.size()) - 1);
+}
+
+AnimatedImageStore* AnimatedImageStore::instance()
+{
+    static AnimatedImageStore s_instance;
+    return &s_instance;
+}
+
+AnimatedImageStore::Info AnimatedImageStore::probe(const QString& path, qint64 maxBytes, int maxEdgePx)
+{
+    MOUFFETTE_TRACE_SCOPE("image", "probe animation");
+    Info info;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return info;
+    const QByteArray head = file.peek(16);
+    if (head.startsWith(QByteArray("\x89PNG\r\n\x1a\n", 8))) {
+        probePng(file, info);
+    } else if (head.startsWith("RIFF") && head.mid(8, 4) == "WEBP") {
+        probeWebp(file, info, maxBytes, maxEdgePx);
+    } else if (head.startsWith("GIF8")) {
+        probeGif(file, info, maxBytes, maxEdgePx);
+    }
+    return info;
+}
+
+std::shared_ptr<AnimatedImage> AnimatedImageStore::decode(const QString& path, const QSize& maxSize, qint64 maxBytes,
+                                                          QString* errorString)
+{
+    MOUFFETTE_TRACE_SCOPE("image", "decode animation");
+    DecodedFrames decoded;
+    DecodeResult result = decodeWithFFmpeg(path, maxSize, maxBytes, decoded);
+    if (result != DecodeResult::TooLarge && decoded.frames.size() < 2) {
+        // e.g. animated WebP, which FFmpeg only demuxes as a single still image before 8.0
+        DecodedFrames viaQt;
+        if (decodeWithQt(path, maxSize, maxBytes, viaQt) != DecodeResult::Unsupported &&
+            viaQt.frames.size() > decoded.frames.size()) {
+            MOUFFETTE_LOG_DEBUG(logDecoder) << "Animated image decoded through QImageReader:" << path;
+            result = viaQt.bytes > maxBytes ? DecodeResult::TooLarge : DecodeResult::Ok;
+            decoded = std::move(viaQt);
+        }
+    }
+    if (result != DecodeResult::Ok) {
+        if (errorString) {
+            *errorString = result == DecodeResult::TooLarge
+                ? QString("%1 has too many frames to cache at %2x%3").arg(path).arg(maxSize.width()).arg(maxSize.height())
+                : QString("Cannot decode %1").arg(path);
+        }
+        return nullptr;
+    }
+
+    auto image = std::make_shared<AnimatedImage>();
+    image->m_frames = std::move(decoded.frames);
+    image->m_hasAlpha = decoded.alpha;
+    image->m_reduced = decoded.reduced;
+    image->m_endMs.reserve(decoded.delaysMs.size());
+    qint64 end = 0;
+    for (qint64 delay : decoded.delaysMs) {
+        end += delay;
+        image->m_endMs.append(end);
+    }
+    return image;
+}
+
+QString AnimatedImageStore::keyOf(const QString& path)
+{
+    // Same file, same content: an edited file gets a new entry
+    const QFileInfo info(path);
+    return info.absoluteFilePath() + QLatin1Char('@') + QString::number(info.lastModified().toMSecsSinceEpoch());
+}
+
+std::shared_ptr<AnimatedImage> AnimatedImageStore::find(const QString& path, const QSize& minSize) const
+{
+    std::shared_ptr<AnimatedImage> image = m_images.value(keyOf(path)).lock();
+    if (!image || !image->isReduced()) return image;
+    const QSize have = image->size();
+    if (minSize.isValid() && have.width() >= minSize.width() && have.height() >= minSize.height()) return image;
+    return nullptr;
+}
+
+std::shared_ptr<AnimatedImage> AnimatedImageStore::insert(const QString& path, std::shared_ptr<AnimatedImage> image)
+{
+    if (!image) return image;
+    const QString key = keyOf(path);
+    if (std::shared_ptr<AnimatedImage> existing = m_images.value(key).lock()) {
+        const QSize have = existing->size();
+        if (!existing->isReduced() || (have.width() >= image->size().width() && have.height() >= image->size().height())) {
+            return existing;
+        }
+    }
+    // Entries of animations nobody shows any more
+    for (auto it = m_images.begin(); it != m_images.end();) {
+        it = it.value().expired() ? m_images.erase(it) : std::next(it);
+    }
+    m_images.insert(key, image);
+    return image;
+}
+
+void AnimatedImageStore::assign(std::shared_ptr<AnimatedImage>& slot, std::shared_ptr<AnimatedImage> image, MediaMemoryClient* holder)
+{
+    if (slot == image) return;
+    std::shared_ptr<AnimatedImage> previous = std::move(slot);
+    if (previous) previous->m_holders.removeOne(holder);
+    slot = std::move(image);
+    if (slot) slot->m_holders.append(holder);
+    MediaMemoryAccountant* accountant = MediaMemoryAccountant::instance();
+    accountant->notifyChanged(holder);
+    if (previous) {
+        for (MediaMemoryClient* other : std::as_const(previous->m_holders)) accountant->notifyChanged(other);
+    }
+    if (slot) {
+        for (MediaMemoryClient* other : std::as_const(slot->m_holders)) {
+            if (other != holder) accountant->notifyChanged(other);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef ANIMATEDIMAGESTORE_H
+#define ANIMATEDIMAGESTORE_H
+
+#include <QHash>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QVector>
+#include <memory>
+
+class MediaMemoryClient;
+
+/**
+ * Every frame of one animated image (GIF, APNG, animated WebP), decoded once at one size.
+ * Immutable once handed out and shared by every item showing the same file, so looping
+ * and extra copies cost no further decode: playback only picks a frame by time.
+ */
+class AnimatedImage {
+public:
+    const QVector<QImage>& frames() const { return m_frames; }
+    int frameCount() const { return m_frames.size(); }
+    // Decoded frame size (the file's size, or smaller when decoded for a smaller view)
+    QSize size() const { return m_frames.isEmpty() ? QSize() : m_frames.first().size(); }
+    bool hasAlpha() const { return m_hasAlpha; }
+    bool isReduced() const { return m_reduced; }
+    qint64 loopDurationMs() const { return m_endMs.isEmpty() ? 0 : m_endMs.last(); }
+    qint64 bytes() const;
+    // Items showing these frames (see AnimatedImageStore::assign); bytes() is split between them
+    int holderCount() const { return m_holders.size(); }
+    // Frame shown timeMs into the animation, looping forever
+    int frameIndexAt(qint64 timeMs) const;
+
+private:
+    friend class AnimatedImageStore;
+    QVector<QImage> m_frames;
+    // End of each frame on the loop's timeline (ms), strictly increasing
+    QVector<qint64> m_endMs;
+    bool m_hasAlpha = false;
+    bool m_reduced = false;
+    QVector<MediaMemoryClient*> m_holders;
+};
+
+/**
+ * Decoding and process-wide sharing of animated images. Frames are decoded through
+ * FFmpeg (which composites GIF/APNG disposal and blending into full frames), falling back
+ * to QImageReader for formats the FFmpeg build cannot demux (animated WebP on older
+ * versions). The store only holds weak references, like SharedImageStore.
+ * GUI thread only, except the static helpers.
+ */
+class AnimatedImageStore {
+public:
+    struct Info {
+        QSize size;
+        int frameCount = 0;
+    };
+
+    static AnimatedImageStore* instance();
+
+    // Container-only probe (no pixel data is decoded); frameCount > 1 for animated files.
+    // With maxBytes, counting stops once the frames, fit in maxEdgePx, would exceed it: the
+    // count is then just past the budget. Safe from any thread.
+    static Info probe(const QString& path, qint64 maxBytes = 0, int maxEdgePx = 0);
+    // Decode every frame, downscaled to fit maxSize when the file is larger. Gives up (and
+    // returns nullptr) past maxBytes of frames. Safe from worker threads.
+    static std::shared_ptr<AnimatedImage> decode(const QString& path, const QSize& maxSize, qint64 maxBytes,
+                                                 QString* errorString = nullptr);
+
+    // Frames of this file covering minSize (or at full resolution), if any item holds them
+    std::shared_ptr<AnimatedImage> find(const QString& path, const QSize& minSize) const;
+    // Share freshly decoded frames; an existing copy at an equal or better size wins
+    std::shared_ptr<AnimatedImage> insert(const QString& path, std::shared_ptr<AnimatedImage> image);
+    // Make `holder` show `image` (or nothing) instead of what `slot` holds, re-accounting every
+    // holder of either animation like SharedImageStore::assign()
+    void assign(std::shared_ptr<AnimatedImage>& slot, std::shared_ptr<AnimatedImage> image, MediaMemoryClient* holder);
+
+private:
+    AnimatedImageStore() = default;
+    static QString keyOf(const QString& path);
+
+    QHash<QString, std::weak_ptr<AnimatedImage>> m_images;
+};
+
+#endif // ANIMATEDIMAGESTORE_H
@@ -16,6 +16,12 @@ struct ScreenInfo {
     ScreenInfo() : id(0), width(0), height(0), x(0), y(0), primary(false) {}
     ScreenInfo(int id, int w, int h, int x, int y, bool p) : id(id), width(w), height(h), x(x), y(y), primary(p) {}
     
+    bool operator==(const ScreenInfo& other) const {
+        return id == other.id && width == other.width && height == other.height &&
+               x == other.x && y == other.y && primary == other.primary;
+    }
+    bool operator!=(const ScreenInfo& other) const { return !(*this == other); }
+    
     QJsonObject toJson() const;
     static ScreenInfo fromJson(const QJsonObject& json);
 };
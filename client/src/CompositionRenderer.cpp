@@ -0,0 +1,477 @@
+#include "CompositionRenderer.h"
+#include "FFmpegVideoDecoder.h"
+#include "Trace.h"
+#include "Log.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImageReader>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <vector>
+
+extern "C" {
+#include <libavutil/opt.h>
+}
+
+namespace {
+
+// A decoder that delivered nothing for this long is treated as finished
+constexpr int kStallTimeoutMs = 10000;
+
+// Wakes the render thread when any decoder delivered a frame or stopped
+struct FrameSignal {
+    QMutex mutex;
+    QWaitCondition cond;
+    void notify()
+    {
+        QMutexLocker locker(&mutex);
+        cond.wakeAll();
+    }
+};
+
+struct VideoTrack {
+    int layer = -1;
+    std::unique_ptr<FFmpegVideoDecoder> decoder;
+    std::shared_ptr<FrameMailbox> mailbox;
+    QImage current;         // shown at the current output time
+    QImage next;            // first frame after it, once pulled
+    qint64 nextTs = -1;
+    bool hasNext = false;
+    bool exhausted = false; // no frames left; current is held
+    std::atomic<bool> playing{false};
+    std::atomic<bool> ended{false};
+};
+
+// Take the next frame of a track into track.next and let its decoder continue.
+// False once the decoder stopped (end of file), stalled or the render was cancelled.
+bool pullFrame(VideoTrack& track, FrameSignal& signal, const std::atomic<bool>& cancel)
+{
+    QElapsedTimer stall;
+    stall.start();
+    {
+        QMutexLocker locker(&signal.mutex);
+        // Lockstep decoders only stop after their last frame was taken
+        while (!track.mailbox->hasFresh()) {
+            if (track.ended.load() || cancel.load() || stall.elapsed() > kStallTimeoutMs) return false;
+            signal.cond.wait(&signal.mutex, 50);
+        }
+    }
+    track.mailbox->consume();
+    // Shares the slot's pixels; the decoder detaches before converting into that slot again
+    track.next = track.mailbox->front().image;
+    track.nextTs = track.mailbox->front().timestampMs;
+    track.hasNext = true;
+    track.decoder->requestNextFrame();
+    return true;
+}
+
+// Make track.current the frame shown at timeMs
+void advanceTrack(VideoTrack& track, qint64 timeMs, FrameSignal& signal, const std::atomic<bool>& cancel)
+{
+    while (!track.exhausted) {
+        if (!track.hasNext && !pullFrame(track, signal, cancel)) {
+            track.exhausted = true;
+            break;
+        }
+        // The first frame is shown from the start even if its timestamp is not 0
+        if (track.nextTs > timeMs && !track.current.isNull()) break;
+        track.current = track.next;
+        track.next = QImage();
+        track.hasNext = false;
+    }
+}
+
+// Output pixels covered by a layer; images and videos are decoded no larger than this
+QSize coveredSize(const CompositionRenderer::Layer& layer)
+{
+    const QRectF r = layer.transform.mapRect(QRectF(QPointF(0, 0), QSizeF(layer.baseSize)));
+    return QSize(std::max(1, static_cast<int>(std::ceil(r.width()))), std::max(1, static_cast<int>(std::ceil(r.height()))));
+}
+
+// Read at the output size it covers (never larger than the file); null with errorString
+// set when the file cannot be read
+QImage loadImageLayer(const CompositionRenderer::Layer& layer, QString* errorString)
+{
+    if (layer.imagePath.isEmpty()) {
+        if (layer.image.isNull()) *errorString = "Empty image layer";
+        return layer.image;
+    }
+    QImageReader reader(layer.imagePath);
+    const QSize full = reader.size();
+    const QSize need = coveredSize(layer);
+    if (full.isValid() && (need.width() < full.width() || need.height() < full.height())) {
+        reader.setScaledSize(full.scaled(need, Qt::KeepAspectRatioByExpanding));
+    }
+    QImage img = reader.read();
+    if (img.isNull()) *errorString = QString("Cannot read %1: %2").arg(layer.imagePath, reader.errorString());
+    return img;
+}
+
+// H.264 (or MPEG-4 Part 2 when no H.264 encoder is built in) in an MP4 container
+class Mp4Encoder {
+public:
+    ~Mp4Encoder() { close(); }
+
+    bool open(const QString& path, const QSize& size, int fps, qint64 bitRate, QString* errorString)
+    {
+        const QByteArray file = path.toUtf8();
+        const AVCodec* codec = avcodec_find_encoder_by_name("libx264");
+        if (!codec) codec = avcodec_find_encoder(AV_CODEC_ID_H264);
+        if (!codec) codec = avcodec_find_encoder(AV_CODEC_ID_MPEG4);
+        if (!codec) return fail(errorString, "No H.264 or MPEG-4 encoder available");
+        if (avformat_alloc_output_context2(&m_fmt, nullptr, "mp4", file.constData()) < 0 || !m_fmt) {
+            return fail(errorString, "MP4 muxer unavailable");
+        }
+        m_enc = avcodec_alloc_context3(codec);
+        m_stream = avformat_new_stream(m_fmt, nullptr);
+        m_pkt = av_packet_alloc();
+        if (!m_enc || !m_stream || !m_pkt) return fail(errorString, "Out of memory");
+        m_enc->width = size.width();
+        m_enc->height = size.height();
+        m_enc->time_base = AVRational{1, fps};
+        m_enc->framerate = AVRational{fps, 1};
+        m_enc->pix_fmt = AV_PIX_FMT_YUV420P;
+        m_enc->gop_size = fps * 2;
+        m_enc->bit_rate = bitRate;
+        m_enc->thread_count = 0;
+        if (m_fmt->oformat->flags & AVFMT_GLOBALHEADER) m_enc->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+        if (QByteArray(codec->name) == "libx264") av_opt_set(m_enc->priv_data, "preset", "veryfast", 0);
+        if (avcodec_open2(m_enc, codec, nullptr) < 0 || avcodec_parameters_from_context(m_stream->codecpar, m_enc) < 0) {
+            return fail(errorString, QString("Encoder %1 rejected %2x%3").arg(codec->name).arg(size.width()).arg(size.height()));
+        }
+        m_stream->time_base = m_enc->time_base;
+        if (avio_open(&m_fmt->pb, file.constData(), AVIO_FLAG_WRITE) < 0) {
+            return fail(errorString, QString("Cannot write %1").arg(path));
+        }
+        // Index up front so players can start before the whole file is read
+        AVDictionary* options = nullptr;
+        av_dict_set(&options, "movflags", "+faststart", 0);
+        const int ret = avformat_write_header(m_fmt, &options);
+        av_dict_free(&options);
+        if (ret < 0) return fail(errorString, QString("Cannot write %1").arg(path));
+        return true;
+    }
+
+    // nullptr flushes the encoder
+    bool write(AVFrame* frame)
+    {
+        MOUFFETTE_TRACE_SCOPE("render", "encode");
+        if (avcodec_send_frame(m_enc, frame) < 0) return false;
+        for (;;) {
+            const int ret = avcodec_receive_packet(m_enc, m_pkt);
+            if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) return true;
+            if (ret < 0) return false;
+            av_packet_rescale_ts(m_pkt, m_enc->time_base, m_stream->time_base);
+            m_pkt->stream_index = m_stream->index;
+            if (av_interleaved_write_frame(m_fmt, m_pkt) < 0) return false;
+        }
+    }
+
+    bool finish() { return write(nullptr) && av_write_trailer(m_fmt) >= 0; }
+
+    // Release the file and codec (after finish(), or to discard a partial file)
+    void close()
+    {
+        if (m_fmt && m_fmt->pb) avio_closep(&m_fmt->pb);
+        av_packet_free(&m_pkt);
+        avcodec_free_context(&m_enc);
+        avformat_free_context(m_fmt);
+        m_fmt = nullptr;
+        m_stream = nullptr;
+    }
+
+private:
+    static bool fail(QString* errorString, const QString& message)
+    {
+        if (errorString) *errorString = message;
+        return false;
+    }
+
+    AVFormatContext* m_fmt = nullptr;
+    AVCodecContext* m_enc = nullptr;
+    AVStream* m_stream = nullptr;
+    AVPacket* m_pkt = nullptr;
+};
+
+// RGB32 -> YUV420P converters, reused across compositing jobs (one per concurrent job)
+class ScalerPool {
+public:
+    explicit ScalerPool(const QSize& size) : m_size(size) {}
+    ~ScalerPool()
+    {
+        for (SwsContext* ctx : m_free) sws_freeContext(ctx);
+    }
+    SwsContext* acquire()
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            if (!m_free.empty()) {
+                SwsContext* ctx = m_free.back();
+                m_free.pop_back();
+                return ctx;
+            }
+        }
+        return sws_getContext(m_size.width(), m_size.height(), AV_PIX_FMT_RGB32,
+                              m_size.width(), m_size.height(), AV_PIX_FMT_YUV420P,
+                              SWS_BILINEAR, nullptr, nullptr, nullptr);
+    }
+    void release(SwsContext* ctx)
+    {
+        if (!ctx) return;
+        QMutexLocker locker(&m_mutex);
+        m_free.push_back(ctx);
+    }
+
+private:
+    QSize m_size;
+    QMutex m_mutex;
+    std::vector<SwsContext*> m_free;
+};
+
+// Composite one output frame and convert it for the encoder; nullptr on failure
+AVFrame* composeFrame(const QSize& size, const QVector<CompositionRenderer::Layer>& layers,
+                      const QVector<QImage>& images, ScalerPool& scalers)
+{
+    MOUFFETTE_TRACE_SCOPE("render", "compose");
+    QImage canvas(size, QImage::Format_RGB32);
+    if (canvas.isNull()) return nullptr;
+    canvas.fill(Qt::black);
+    {
+        QPainter painter(&canvas);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        for (int i = 0; i < layers.size(); ++i) {
+            const QImage& img = images[i];
+            if (img.isNull()) continue;
+            painter.setTransform(layers[i].transform);
+            painter.drawImage(QRectF(QPointF(0, 0), QSizeF(layers[i].baseSize)), img, QRectF(img.rect()));
+        }
+    }
+    AVFrame* frame = av_frame_alloc();
+    if (!frame) return nullptr;
+    frame->format = AV_PIX_FMT_YUV420P;
+    frame->width = size.width();
+    frame->height = size.height();
+    SwsContext* sws = scalers.acquire();
+    const uint8_t* src[4] = { canvas.constBits(), nullptr, nullptr, nullptr };
+    const int srcStride[4] = { static_cast<int>(canvas.bytesPerLine()), 0, 0, 0 };
+    const bool ok = sws && av_frame_get_buffer(frame, 0) >= 0
+        && sws_scale(sws, src, srcStride, 0, size.height(), frame->data, frame->linesize) >= 0;
+    scalers.release(sws);
+    if (!ok) av_frame_free(&frame);
+    return frame;
+}
+
+} // namespace
+
+CompositionRenderer::CompositionRenderer(QObject* parent)
+    : QObject(parent)
+{
+    connect(this, &CompositionRenderer::finished, this, &CompositionRenderer::restoreAllocationLimit);
+}
+
+CompositionRenderer::~CompositionRenderer()
+{
+    if (m_thread) {
+        m_cancel.store(true);
+        m_thread->wait();
+        delete m_thread;
+    }
+    restoreAllocationLimit();
+}
+
+void CompositionRenderer::restoreAllocationLimit()
+{
+    if (m_previousAllocationLimitMb < 0) return;
+    QImageReader::setAllocationLimit(m_previousAllocationLimitMb);
+    m_previousAllocationLimitMb = -1;
+}
+
+bool CompositionRenderer::isRunning() const
+{
+    return m_thread && m_thread->isRunning();
+}
+
+bool CompositionRenderer::start(const Settings& settings, const QVector<Layer>& layers)
+{
+    if (isRunning()) return false;
+    delete m_thread;
+    m_settings = settings;
+    m_layers = layers;
+    m_cancel.store(false);
+    // Formats without native scaled reads (PNG...) decode at full size first: make room for
+    // the largest image (tiled ones exceed Qt's 256 MB default). Set here, on the GUI thread,
+    // since the limit is process-wide; restored once the render finishes.
+    qint64 neededMb = 0;
+    for (const Layer& layer : m_layers) {
+        if (layer.imagePath.isEmpty()) continue;
+        const QSize full = QImageReader(layer.imagePath).size();
+        if (full.isValid()) neededMb = std::max(neededMb, static_cast<qint64>(full.width()) * full.height() * 4 / (1024 * 1024) + 1);
+    }
+    if (QImageReader::allocationLimit() > 0 && neededMb > QImageReader::allocationLimit()) {
+        if (m_previousAllocationLimitMb < 0) m_previousAllocationLimitMb = QImageReader::allocationLimit();
+        QImageReader::setAllocationLimit(static_cast<int>(std::min<qint64>(neededMb, INT_MAX)));
+    }
+    m_thread = QThread::create([this]() {
+        QString error;
+        const bool ok = run(&error);
+        // Queued to the renderer's thread
+        emit finished(ok, error);
+    });
+    m_thread->setObjectName("CompositionRenderer");
+    m_thread->start();
+    return true;
+}
+
+bool CompositionRenderer::run(QString* errorString)
+{
+    const QSize size(m_settings.size.width() & ~1, m_settings.size.height() & ~1);
+    const int fps = std::clamp(m_settings.fps, 1, 240);
+    if (size.isEmpty()) {
+        *errorString = "Invalid output size";
+        return false;
+    }
+    QElapsedTimer wall;
+    wall.start();
+
+    // Decoders first: they open and decode in parallel while the images load
+    FrameSignal signal;
+    std::vector<std::unique_ptr<VideoTrack>> tracks;
+    for (int i = 0; i < m_layers.size(); ++i) {
+        const Layer& layer = m_layers[i];
+        if (layer.videoPath.isEmpty()) continue;
+        auto track = std::make_unique<VideoTrack>();
+        VideoTrack* t = track.get();
+        t->layer = i;
+        t->decoder = std::make_unique<FFmpegVideoDecoder>();
+        t->mailbox = t->decoder->frameMailbox();
+        QObject::connect(t->decoder.get(), &FFmpegVideoDecoder::frameAvailable, [&signal]() {
+            signal.notify();
+        });
+        QObject::connect(t->decoder.get(), &FFmpegVideoDecoder::playbackStateChanged, [t, &signal](FFmpegVideoDecoder::PlaybackState s) {
+            // Opening a file reports Stopped too: only a stop after playing is the end
+            if (s == FFmpegVideoDecoder::PlaybackState::Playing) t->playing.store(true);
+            else if (s == FFmpegVideoDecoder::PlaybackState::Stopped && t->playing.load()) t->ended.store(true);
+            signal.notify();
+        });
+        t->decoder->setPacingMode(FFmpegVideoDecoder::PacingMode::Lockstep);
+        t->decoder->setVisibility(true, coveredSize(layer));
+        t->decoder->moveToWorkerThread();
+        t->decoder->setSource(layer.videoPath);
+        t->decoder->play();
+        tracks.push_back(std::move(track));
+    }
+    QVector<QImage> stills(m_layers.size());
+    for (int i = 0; i < m_layers.size(); ++i) {
+        if (!m_layers[i].videoPath.isEmpty()) continue;
+        stills[i] = loadImageLayer(m_layers[i], errorString);
+        // A missing layer would silently change the composition
+        if (stills[i].isNull()) return false;
+    }
+
+    // First frames tell the durations
+    qint64 durationMs = m_settings.durationMs;
+    qint64 longestVideoMs = 0;
+    for (auto& track : tracks) {
+        advanceTrack(*track, 0, signal, m_cancel);
+        if (track->current.isNull()) qWarning() << "Composition render: no frames from" << m_layers[track->layer].videoPath;
+        longestVideoMs = std::max(longestVideoMs, track->decoder->duration());
+    }
+    if (durationMs <= 0) durationMs = longestVideoMs > 0 ? longestVideoMs : StillDurationMs;
+    const int totalFrames = std::max(1, static_cast<int>((durationMs * fps + 999) / 1000));
+
+    Mp4Encoder encoder;
+    const qint64 bitRate = m_settings.bitRate > 0 ? m_settings.bitRate
+                                                  : static_cast<qint64>(size.width()) * size.height() * fps / 8;
+    if (!encoder.open(m_settings.outputPath, size, fps, bitRate, errorString)) return false;
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(m_settings.threads > 0 ? m_settings.threads : QThread::idealThreadCount());
+    const int maxInFlight = pool.maxThreadCount() * 2;
+    ScalerPool scalers(size);
+    // Composited frames waiting for their turn at the encoder, by index (nullptr = failed)
+    QMutex resultMutex;
+    QWaitCondition resultReady;
+    std::map<int, AVFrame*> results;
+    int submitted = 0;
+    int encoded = 0;
+    bool ok = true;
+
+    // Encode frames in order as they complete; with `wait`, block for the next one
+    auto drain = [&](bool wait) {
+        for (;;) {
+            AVFrame* frame = nullptr;
+            {
+                QMutexLocker locker(&resultMutex);
+                auto it = results.find(encoded);
+                while (wait && it == results.end()) {
+                    resultReady.wait(&resultMutex);
+                    it = results.find(encoded);
+                }
+                if (it == results.end()) return;
+                frame = it->second;
+                results.erase(it);
+            }
+            if (!frame) {
+                *errorString = "Compositing failed";
+                ok = false;
+            } else {
+                frame->pts = encoded;
+                if (ok && !encoder.write(frame)) {
+                    *errorString = "Encoding failed";
+                    ok = false;
+                }
+                av_frame_free(&frame);
+            }
+            ++encoded;
+            if (encoded % 10 == 0 || encoded == totalFrames) emit progress(encoded, totalFrames);
+            wait = false;
+        }
+    };
+
+    for (int n = 0; n < totalFrames && ok && !m_cancel.load(); ++n) {
+        const qint64 timeMs = static_cast<qint64>(n) * 1000 / fps;
+        QVector<QImage> images = stills;
+        for (auto& track : tracks) {
+            advanceTrack(*track, timeMs, signal, m_cancel);
+            images[track->layer] = track->current;
+        }
+        if (submitted - encoded >= maxInFlight) drain(true);
+        pool.start([&, n, images = std::move(images)]() {
+            AVFrame* frame = composeFrame(size, m_layers, images, scalers);
+            QMutexLocker locker(&resultMutex);
+            results[n] = frame;
+            resultReady.wakeAll();
+        });
+        ++submitted;
+        drain(false);
+    }
+    while (encoded < submitted) drain(true);
+    pool.waitForDone();
+    tracks.clear();
+
+    if (ok && m_cancel.load()) {
+        errorString->clear();
+        ok = false;
+    }
+    if (ok && !encoder.finish()) {
+        *errorString = "Encoding failed";
+        ok = false;
+    }
+    encoder.close();
+    if (!ok) {
+        QFile::remove(m_settings.outputPath);
+        return false;
+    }
+    const double seconds = wall.nsecsElapsed() / 1.0e9;
+    MOUFFETTE_LOG_INFO(logVideo) << "Composition rendered:" << totalFrames << "frames" << size
+                                 << "in" << seconds << "s (" << (seconds > 0 ? totalFrames / seconds : 0.0) << "fps)";
+    return true;
+}
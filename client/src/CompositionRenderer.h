@@ -0,0 +1,77 @@
+#ifndef COMPOSITIONRENDERER_H
+#define COMPOSITIONRENDERER_H
+
+#include <QObject>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QTransform>
+#include <QVector>
+#include <atomic>
+
+class QThread;
+
+/**
+ * Offline render of a canvas composition (videos and images with their transforms) to an
+ * H.264 MP4, faster than real time.
+ *
+ * Runs on its own thread: every video gets an FFmpegVideoDecoder in Lockstep pacing (each
+ * frame decoded as fast as possible, none dropped) converting at the size it covers in the
+ * output, output frames are composited and converted to YUV on a worker pool, and the
+ * render thread feeds them to the encoder in order. Frames in flight are bounded, so memory
+ * stays flat on long renders. Videos shorter than the composition hold their last frame.
+ */
+class CompositionRenderer : public QObject {
+    Q_OBJECT
+
+public:
+    struct Layer {
+        // Video layer when set; otherwise an image read from imagePath (at the size it covers)
+        // or, without a path, the pixels in image
+        QString videoPath;
+        QString imagePath;
+        QImage image;
+        // Item rect (0, 0, baseSize) is drawn through transform into output pixels
+        QSize baseSize;
+        QTransform transform;
+    };
+
+    struct Settings {
+        QString outputPath;
+        QSize size;             // output pixels, rounded down to even
+        int fps = 30;
+        qint64 durationMs = 0;  // 0: longest video, StillDurationMs without videos
+        qint64 bitRate = 0;     // 0: derived from size and fps
+        int threads = 0;        // compositing threads, 0: QThread::idealThreadCount()
+    };
+
+    static constexpr qint64 StillDurationMs = 5000;
+
+    explicit CompositionRenderer(QObject* parent = nullptr);
+    ~CompositionRenderer() override;
+
+    // Layers bottom to top. Returns false when already running.
+    bool start(const Settings& settings, const QVector<Layer>& layers);
+    void cancel() { m_cancel.store(true); }
+    bool isRunning() const;
+
+signals:
+    // Delivered on the thread owning the renderer
+    void progress(int framesEncoded, int framesTotal);
+    // errorString is empty when the render was cancelled
+    void finished(bool ok, const QString& errorString);
+
+private:
+    bool run(QString* errorString);
+    // Undo start()'s process-wide QImageReader allocation limit raise, if any
+    void restoreAllocationLimit();
+
+    Settings m_settings;
+    QVector<Layer> m_layers;
+    QThread* m_thread = nullptr;
+    std::atomic<bool> m_cancel{false};
+    // Limit (MB) in force before start() raised it; -1 when not raised
+    int m_previousAllocationLimitMb = -1;
+};
+
+#endif // COMPOSITIONRENDERER_H
@@ -1,18 +1,30 @@
 #include "FFmpegVideoDecoder.h"
+#include "Trace.h"
+#include "Log.h"
 #include <QDebug>
 #include <QThread>
 #include <QCoreApplication>
 #include <QElapsedTimer>
 #include <QDateTime>
+#include <algorithm>
+#include <cmath>
 #include <mutex>
 
+namespace {
+// Budget for decoding from a keyframe up to a target position while playing (seek, resync):
+// past it, the regular playback loop keeps dropping frames until it catches up
+constexpr int kCatchUpMaxIterations = 1000;
+constexpr int kCatchUpMaxTimeMs = 250;
+}
+
 FFmpegVideoDecoder::FFmpegVideoDecoder(QObject* parent)
     : QObject(parent)
+    , m_mailbox(std::make_shared<FrameMailbox>())
 {
     // Initialize FFmpeg (thread-safe after FFmpeg 4.0)
     static std::once_flag ffmpegInit;
     std::call_once(ffmpegInit, []() {
-        qDebug() << "Initializing FFmpeg libraries";
+        MOUFFETTE_LOG_DEBUG(logDecoder) << "Initializing FFmpeg libraries";
         // Most initialization is automatic in modern FFmpeg
     });
 }
@@ -67,6 +79,37 @@ void FFmpegVideoDecoder::requestFirstFrame()
     }
 }
 
+void FFmpegVideoDecoder::requestNextFrame()
+{
+    QMetaObject::invokeMethod(this, &FFmpegVideoDecoder::processFrame, Qt::QueuedConnection);
+}
+
+void FFmpegVideoDecoder::setPacingMode(PacingMode mode)
+{
+    if (m_pacingMode.exchange(mode) == mode) return;
+    QMetaObject::invokeMethod(this, &FFmpegVideoDecoder::applyPacingMode, Qt::QueuedConnection);
+}
+
+void FFmpegVideoDecoder::applyPacingMode()
+{
+    if (!m_playbackTimer || m_playbackState.load() != PlaybackState::Playing) return;
+    if (m_pacingMode.load() == PacingMode::Unpaced) {
+        // Frames re-queue themselves; the timer would only pile extra passes onto the queue
+        m_playbackTimer->stop();
+        continueUnpaced();
+    } else if (!m_playbackTimer->isActive()) {
+        m_playbackTimer->setInterval(static_cast<int>(m_frameInterval));
+        m_playbackTimer->start();
+    }
+}
+
+void FFmpegVideoDecoder::continueUnpaced()
+{
+    if (m_pacingMode.load() != PacingMode::Unpaced || m_playbackState.load() != PlaybackState::Playing) return;
+    // Queued rather than looping here so control commands still get through
+    QMetaObject::invokeMethod(this, &FFmpegVideoDecoder::processFrame, Qt::QueuedConnection);
+}
+
 void FFmpegVideoDecoder::setSource(const QString& filePath)
 {
     QMutexLocker locker(&m_commandMutex);
@@ -196,9 +239,44 @@ void FFmpegVideoDecoder::setPlaybackRate(double rate)
     }
 }
 
+void FFmpegVideoDecoder::resetTimingHistograms()
+{
+    m_decodeTimeHistogram.reset();
+    m_conversionTimeHistogram.reset();
+    m_publishLatenessHistogram.reset();
+    m_publishIntervalHistogram.reset();
+}
+
+void FFmpegVideoDecoder::setVisibility(bool visible, const QSize& targetSizePx)
+{
+    // Plain atomics: the worker picks these up on its next tick or conversion
+    m_targetWidth.store(targetSizePx.isValid() ? targetSizePx.width() : 0);
+    m_targetHeight.store(targetSizePx.isValid() ? targetSizePx.height() : 0);
+    const bool wasVisible = m_visible.exchange(visible);
+
+    if (!visible || !m_workerThread || !m_workerThread->isRunning()) {
+        return;
+    }
+    if (m_playbackState.load() == PlaybackState::Playing) {
+        if (!wasVisible) {
+            // Kick the loop so the keyframe resync does not wait for the next tick
+            QMetaObject::invokeMethod(this, &FFmpegVideoDecoder::processFrame, Qt::QueuedConnection);
+        }
+        return;
+    }
+    // Paused/stopped: the frame on screen may have been converted for a smaller view.
+    // Re-decode the current position once if the item now needs more pixels.
+    QMetaObject::invokeMethod(this, [this]() {
+        if (!m_formatContext || !m_codecContext || m_playbackState.load() == PlaybackState::Playing) return;
+        if (m_outputSize.isValid() && desiredOutputSize().width() > m_outputSize.width()) {
+            seekToPosition(m_position.load());
+        }
+    }, Qt::QueuedConnection);
+}
+
 void FFmpegVideoDecoder::initializeDecoder()
 {
-    qDebug() << "Initializing FFmpeg decoder in thread:" << QThread::currentThread();
+    MOUFFETTE_LOG_DEBUG(logDecoder) << "Initializing FFmpeg decoder in thread:" << QThread::currentThread();
     
     // Create high-precision playback timer in worker thread
     m_playbackTimer = new QTimer(this);
@@ -226,7 +304,7 @@ void FFmpegVideoDecoder::initializeDecoder()
 
 void FFmpegVideoDecoder::cleanupDecoder()
 {
-    qDebug() << "Cleaning up FFmpeg decoder";
+    MOUFFETTE_LOG_DEBUG(logDecoder) << "Cleaning up FFmpeg decoder";
     
     if (m_playbackTimer) {
         m_playbackTimer->stop();
@@ -239,7 +317,7 @@ void FFmpegVideoDecoder::cleanupDecoder()
 
 bool FFmpegVideoDecoder::openFile(const QString& filePath)
 {
-    qDebug() << "Opening file:" << filePath;
+    MOUFFETTE_LOG_DEBUG(logDecoder) << "Opening file:" << filePath;
     
     // Close any existing file
     closeFile();
@@ -297,15 +375,17 @@ bool FFmpegVideoDecoder::openFile(const QString& filePath)
     
     // Allocate frames
     m_frame = av_frame_alloc();
-    m_frameRGB = av_frame_alloc();
-    if (!m_frame || !m_frameRGB) {
+    if (!m_frame) {
         emit error("Cannot allocate frames");
         closeFile();
         return false;
     }
     
     // Set video properties
-    m_videoSize = QSize(m_codecContext->width, m_codecContext->height);
+    {
+        QMutexLocker stateLocker(&m_stateMutex);
+        m_videoSize = QSize(m_codecContext->width, m_codecContext->height);
+    }
     m_hasVideo = true;
     
     // Calculate duration
@@ -317,24 +397,8 @@ bool FFmpegVideoDecoder::openFile(const QString& filePath)
         m_duration.store(0); // Unknown duration
     }
     
-    // Allocate buffer for RGBA conversion
-    int numBytes = av_image_get_buffer_size(AV_PIX_FMT_RGBA, m_codecContext->width, m_codecContext->height, 1);
-    m_buffer = static_cast<uint8_t*>(av_malloc(numBytes * sizeof(uint8_t)));
-    if (av_image_fill_arrays(m_frameRGB->data, m_frameRGB->linesize, m_buffer, AV_PIX_FMT_RGBA, 
-                        m_codecContext->width, m_codecContext->height, 1) < 0) {
-        emit error("Failed to setup frame buffers");
-        closeFile();
-        return false;
-    }
-    
-    // Initialize scaling context with RGBA output for Qt
-    m_swsContext = sws_getContext(
-        m_codecContext->width, m_codecContext->height, m_codecContext->pix_fmt,
-        m_codecContext->width, m_codecContext->height, AV_PIX_FMT_RGBA,
-        SWS_BILINEAR | SWS_ACCURATE_RND, nullptr, nullptr, nullptr
-    );
-    
-    if (!m_swsContext) {
+    // Set up RGB32 conversion for the current view size
+    if (!ensureConversionSize(desiredOutputSize())) {
         emit error("Cannot initialize scaling context");
         closeFile();
         return false;
@@ -351,11 +415,11 @@ bool FFmpegVideoDecoder::openFile(const QString& filePath)
             // Ensure we have a reasonable interval (between 1ms and 100ms)
             m_frameInterval = std::clamp<qint64>(m_frameInterval, 1, 100);
             
-            qDebug() << "Video fps:" << fps << "frame interval:" << m_frameInterval << "ms";
+            MOUFFETTE_LOG_DEBUG(logDecoder) << "Video fps:" << fps << "frame interval:" << m_frameInterval << "ms";
         }
     }
     
-    qDebug() << "Successfully opened video:" << m_videoSize << "duration:" << m_duration << "ms"
+    MOUFFETTE_LOG_DEBUG(logDecoder) << "Successfully opened video:" << m_videoSize << "duration:" << m_duration << "ms"
              << "frame interval:" << m_frameInterval << "ms";
     
     // Emit signals
@@ -378,21 +442,11 @@ void FFmpegVideoDecoder::closeFile()
         m_swsContext = nullptr;
     }
     
-    if (m_buffer) {
-        av_free(m_buffer);
-        m_buffer = nullptr;
-    }
-    
     if (m_frame) {
         av_frame_free(&m_frame);
         m_frame = nullptr;
     }
     
-    if (m_frameRGB) {
-        av_frame_free(&m_frameRGB);
-        m_frameRGB = nullptr;
-    }
-    
     if (m_codecContext) {
         avcodec_free_context(&m_codecContext);
         m_codecContext = nullptr;
@@ -405,13 +459,48 @@ void FFmpegVideoDecoder::closeFile()
     
     m_videoStreamIndex = -1;
     m_hasVideo = false;
-    m_videoSize = QSize();
+    m_outputSize = QSize();
+    m_resyncPending = false;
+    {
+        QMutexLocker stateLocker(&m_stateMutex);
+        m_videoSize = QSize();
+    }
     m_duration.store(0);
     m_position.store(0);
 }
 
+int FFmpegVideoDecoder::readPacket(AVPacket* packet)
+{
+    MOUFFETTE_TRACE_SCOPE("decoder", "demux");
+    return av_read_frame(m_formatContext, packet);
+}
+
+int FFmpegVideoDecoder::sendPacket(AVPacket* packet)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const int ret = avcodec_send_packet(m_codecContext, packet);
+    m_pendingDecodeNs += timer.nsecsElapsed();
+    return ret;
+}
+
+bool FFmpegVideoDecoder::receiveFrame()
+{
+    QElapsedTimer timer;
+    timer.start();
+    const bool got = avcodec_receive_frame(m_codecContext, m_frame) == 0;
+    m_pendingDecodeNs += timer.nsecsElapsed();
+    if (got) {
+        // Everything sent or received since the previous frame was spent producing this one
+        m_decodeTimeHistogram.recordNs(m_pendingDecodeNs);
+        m_pendingDecodeNs = 0;
+    }
+    return got;
+}
+
 bool FFmpegVideoDecoder::seekToPosition(qint64 positionMs)
 {
+    MOUFFETTE_TRACE_SCOPE("decoder", "seek");
     if (!m_formatContext || m_videoStreamIndex < 0) {
         return false;
     }
@@ -429,6 +518,8 @@ bool FFmpegVideoDecoder::seekToPosition(qint64 positionMs)
     
     m_position.store(positionMs);
     m_seekRequested = false;
+    // An explicit seek presents a fresh frame below, so no keyframe resync is needed
+    m_resyncPending = false;
     
     emit positionChanged(m_position);
     // If currently playing, update playback anchors so timing remains correct
@@ -448,24 +539,22 @@ bool FFmpegVideoDecoder::seekToPosition(qint64 positionMs)
             // budget so playback can resume without heavy stuttering; for paused/preview
             // keep the budget small for snappy UI.
             const int maxIterationsFast = 64;
-            const int maxIterationsPlay = 1000;
+            const int maxIterationsPlay = kCatchUpMaxIterations;
             const int maxTimeMsFast = 80;
-            const int maxTimeMsPlay = 250;
+            const int maxTimeMsPlay = kCatchUpMaxTimeMs;
             bool isPlaying = (m_playbackState.load() == PlaybackState::Playing);
             int maxIter = isPlaying ? maxIterationsPlay : maxIterationsFast;
             int maxTime = isPlaying ? maxTimeMsPlay : maxTimeMsFast;
 
             QElapsedTimer timer; timer.start();
-            while (av_read_frame(m_formatContext, pkt) >= 0) {
+            while (readPacket(pkt) >= 0) {
                 if (pkt->stream_index != m_videoStreamIndex) { av_packet_unref(pkt); continue; }
-                if (avcodec_send_packet(m_codecContext, pkt) < 0) { av_packet_unref(pkt); continue; }
-                while (avcodec_receive_frame(m_codecContext, m_frame) == 0) {
+                if (sendPacket(pkt) < 0) { av_packet_unref(pkt); continue; }
+                while (receiveFrame()) {
                     qint64 ts = getFrameTimestampMs(m_frame);
                     if (ts >= positionMs) {
-                        QImage image = convertFrameToQImage(m_frame);
-                        if (!image.isNull()) {
+                        if (presentFrame(m_frame, ts)) {
                             m_position.store(ts);
-                            emit frameReady(image, ts);
                             emit positionChanged(ts);
                             gotFrame = true;
                         }
@@ -500,6 +589,7 @@ bool FFmpegVideoDecoder::seekToPosition(qint64 positionMs)
 
 void FFmpegVideoDecoder::processFrame()
 {
+    MOUFFETTE_TRACE_SCOPE("decoder", "tick");
     static int frameCount = 0;
     static qint64 lastFrameTime = 0;
     
@@ -515,6 +605,7 @@ void FFmpegVideoDecoder::processFrame()
     if (m_seekRequested) {
         seekToPosition(m_seekPosition);
         lastFrameTime = 0;  // Reset timing after seek
+        continueUnpaced();
         return;
     }
     
@@ -529,6 +620,17 @@ void FFmpegVideoDecoder::processFrame()
     qint64 wallElapsed = currentTime - m_playbackStartSystemMs;
     double rate = static_cast<double>(m_playbackRate.load());
     qint64 desiredVideoMs = m_playbackStartVideoMs + static_cast<qint64>(wallElapsed * rate);
+    // Unpaced: the clock follows the frames instead of the wall, next decoded frame is due now
+    const PacingMode pacing = m_pacingMode.load();
+    const bool unpaced = pacing != PacingMode::RealTime;
+    // Lockstep: wait for the consumer to take the pending frame (requestNextFrame() or the
+    // playback timer brings us back)
+    if (pacing == PacingMode::Lockstep && m_mailbox->hasFresh()) {
+        return;
+    }
+    if (unpaced) {
+        desiredVideoMs = m_position.load() + 1;
+    }
     // Enforce post-seek minimum position to avoid brief regressions
     qint64 guard = m_minPositionAfterSeek.load();
     if (guard >= 0 && desiredVideoMs < guard) {
@@ -546,7 +648,7 @@ void FFmpegVideoDecoder::processFrame()
     // signal EOF to the UI rather than waiting for an exact-frame match.
     qint64 knownDur = m_duration.load();
     if (knownDur > 0 && desiredVideoMs >= knownDur) {
-        qDebug() << "Desired time" << desiredVideoMs << ">= duration" << knownDur << "-> marking EOF";
+        MOUFFETTE_LOG_DEBUG(logDecoder) << "Desired time" << desiredVideoMs << ">= duration" << knownDur << "-> marking EOF";
         // Ensure we update the final position and notify listeners
         m_position.store(knownDur);
         emit positionChanged(knownDur);
@@ -555,7 +657,7 @@ void FFmpegVideoDecoder::processFrame()
     }
     
     if (++frameCount % 30 == 0) {
-        qDebug() << "Processing frame" << frameCount 
+        MOUFFETTE_LOG_TRACE(logDecoder) << "Processing frame" << frameCount 
                  << "state:" << static_cast<int>(m_playbackState.load())
                  << "thread:" << QThread::currentThread()
                  << "wallElapsed:" << wallElapsed << "ms"
@@ -568,20 +670,18 @@ void FFmpegVideoDecoder::processFrame()
         bool posterEmitted = false;
         AVPacket* pkt = av_packet_alloc();
         if (!pkt) return;
-        while (av_read_frame(m_formatContext, pkt) >= 0) {
+        while (readPacket(pkt) >= 0) {
             if (pkt->stream_index != m_videoStreamIndex) { av_packet_unref(pkt); continue; }
-            if (avcodec_send_packet(m_codecContext, pkt) < 0) { av_packet_unref(pkt); continue; }
-            if (avcodec_receive_frame(m_codecContext, m_frame) == 0) {
-                QImage image = convertFrameToQImage(m_frame);
-                if (!image.isNull()) {
-                    qint64 timestamp = getFrameTimestampMs(m_frame);
-                    // Apply guard: do not regress below the requested seek point
-                    qint64 guardTs = m_minPositionAfterSeek.load();
-                    if (guardTs >= 0 && timestamp < guardTs) {
-                        timestamp = guardTs;
-                    }
+            if (sendPacket(pkt) < 0) { av_packet_unref(pkt); continue; }
+            if (receiveFrame()) {
+                qint64 timestamp = getFrameTimestampMs(m_frame);
+                // Apply guard: do not regress below the requested seek point
+                qint64 guardTs = m_minPositionAfterSeek.load();
+                if (guardTs >= 0 && timestamp < guardTs) {
+                    timestamp = guardTs;
+                }
+                if (presentFrame(m_frame, timestamp)) {
                     m_position.store(timestamp);
-                    emit frameReady(image, timestamp);
                     emit positionChanged(timestamp);
                     // Clear guard once satisfied
                     if (guardTs >= 0 && timestamp >= guardTs) {
@@ -603,6 +703,24 @@ void FFmpegVideoDecoder::processFrame()
         return;
     }
 
+    // Hidden item: keep the clock running but skip demux, decode and conversion entirely.
+    // Unpaced playback has no wall clock to follow, so it pauses here (the queued chain ends)
+    // until setVisibility(true) kicks it again.
+    if (!m_visible.load()) {
+        m_position.store(desiredVideoMs);
+        emit positionChanged(desiredVideoMs);
+        m_resyncPending = true;
+        return;
+    }
+
+    // Visible again after a hidden stretch: catch up from a keyframe instead of the old GOP
+    if (m_resyncPending) {
+        m_resyncPending = false;
+        resyncToKeyframe(desiredVideoMs);
+        continueUnpaced();
+        return;
+    }
+
     AVPacket* packet = av_packet_alloc();
     if (!packet) {
         return;
@@ -612,11 +730,11 @@ void FFmpegVideoDecoder::processFrame()
     bool emitted = false;
     int decodeIterations = 0;
     const int maxDecodeIterations = 8; // safety cap per tick to avoid long blocking
-    qDebug() << "Desired video ms:" << desiredVideoMs << "current pos:" << m_position.load();
-    while (av_read_frame(m_formatContext, packet) >= 0) {
+    MOUFFETTE_LOG_TRACE(logDecoder) << "Desired video ms:" << desiredVideoMs << "current pos:" << m_position.load();
+    while (readPacket(packet) >= 0) {
         if (++decodeIterations > maxDecodeIterations) {
             // Avoid spending too long in one tick; we'll continue next tick
-            qDebug() << "Decode iteration limit reached:" << decodeIterations;
+            MOUFFETTE_LOG_TRACE(logDecoder) << "Decode iteration limit reached:" << decodeIterations;
             break;
         }
         if (packet->stream_index != m_videoStreamIndex) {
@@ -624,14 +742,15 @@ void FFmpegVideoDecoder::processFrame()
             continue;
         }
 
-        if (avcodec_send_packet(m_codecContext, packet) < 0) {
+        MOUFFETTE_TRACE_SCOPE("decoder", "decode");
+        if (sendPacket(packet) < 0) {
             av_packet_unref(packet);
             continue;
         }
 
-        while (avcodec_receive_frame(m_codecContext, m_frame) == 0) {
+        while (receiveFrame()) {
             qint64 timestamp = getFrameTimestampMs(m_frame);
-            qDebug() << "Decoded frame ts:" << timestamp << "desired:" << desiredVideoMs;
+            MOUFFETTE_LOG_TRACE(logDecoder) << "Decoded frame ts:" << timestamp << "desired:" << desiredVideoMs;
             // Enforce guard: skip frames that regress below seek target
             qint64 guardTs = m_minPositionAfterSeek.load();
             if (guardTs >= 0 && timestamp < guardTs) {
@@ -639,25 +758,24 @@ void FFmpegVideoDecoder::processFrame()
                 continue;
             }
             // If this frame is in the future, present it and stop decoding further
-            if (timestamp >= desiredVideoMs) {
-                QImage image = convertFrameToQImage(m_frame);
-                    if (!image.isNull()) {
-                        // Clamp emitted timestamp to guard if necessary
-                        if (guardTs >= 0 && timestamp < guardTs) {
-                            timestamp = guardTs;
-                        }
-                        m_position.store(timestamp);
-                        emit frameReady(image, timestamp);
-                        emit positionChanged(timestamp);
-                        // Guard satisfied, clear it
-                        if (guardTs >= 0 && timestamp >= guardTs) {
-                            m_minPositionAfterSeek.store(-1);
-                        }
-                        emitted = true;
+            if (timestamp >= desiredVideoMs || unpaced) {
+                // Clamp emitted timestamp to guard if necessary
+                if (guardTs >= 0 && timestamp < guardTs) {
+                    timestamp = guardTs;
+                }
+                if (presentFrame(m_frame, timestamp)) {
+                    m_position.store(timestamp);
+                    emit positionChanged(timestamp);
+                    // Guard satisfied, clear it
+                    if (guardTs >= 0 && timestamp >= guardTs) {
+                        m_minPositionAfterSeek.store(-1);
                     }
+                    emitted = true;
+                }
                 break; // stop inner receive loop and break to outer
             } else {
                 // Older frame; drop
+                m_lateFrames.fetch_add(1, std::memory_order_relaxed);
             }
         }
         
@@ -667,10 +785,14 @@ void FFmpegVideoDecoder::processFrame()
     // Free packet buffer allocated earlier
     av_packet_free(&packet);
 
+    if (emitted) {
+        continueUnpaced();
+    }
+
     if (!emitted) {
         // No frame emitted this tick; if format indicates EOF, stop playback
         if (m_formatContext && m_formatContext->pb && avio_feof(m_formatContext->pb)) {
-            qDebug() << "End of file reached, stopping playback";
+            MOUFFETTE_LOG_DEBUG(logDecoder) << "End of file reached, stopping playback";
             // Set position to duration (if known) so UI can treat this as EOF/at-end.
             qint64 dur = m_duration.load();
             if (dur > 0) {
@@ -680,6 +802,9 @@ void FFmpegVideoDecoder::processFrame()
             updatePlaybackState(PlaybackState::Stopped);
             // Do NOT seek to 0 here; let UI handle repeat/seek behavior so we avoid
             // overwriting the final position immediately and confusing overlay logic.
+        } else if (pacing == PacingMode::Unpaced) {
+            // Nothing decodable yet and no timer running: retry one frame interval later
+            QTimer::singleShot(static_cast<int>(m_frameInterval), this, &FFmpegVideoDecoder::processFrame);
         }
     }
 }
@@ -698,26 +823,153 @@ void FFmpegVideoDecoder::performPendingSeek()
     }
 }
 
-QImage FFmpegVideoDecoder::convertFrameToQImage(AVFrame* frame)
+void FFmpegVideoDecoder::resyncToKeyframe(qint64 positionMs)
+{
+    if (!m_formatContext || !m_codecContext || m_videoStreamIndex < 0) {
+        return;
+    }
+
+    // Decode from the keyframe before the clock and drop frames until we reach it. The
+    // playback anchor is left alone: content is caught up with, never skipped.
+    AVStream* videoStream = m_formatContext->streams[m_videoStreamIndex];
+    int64_t timestamp = av_rescale_q(positionMs * 1000, AV_TIME_BASE_Q, videoStream->time_base);
+    if (av_seek_frame(m_formatContext, m_videoStreamIndex, timestamp, AVSEEK_FLAG_BACKWARD) < 0) {
+        qWarning() << "Resync seek failed at position:" << positionMs;
+        return;
+    }
+    avcodec_flush_buffers(m_codecContext);
+
+    AVPacket* pkt = av_packet_alloc();
+    if (!pkt) return;
+    const bool playing = m_playbackState.load() == PlaybackState::Playing;
+    const double rate = m_playbackRate.load();
+    QElapsedTimer timer;
+    timer.start();
+    int decodeIterations = 0;
+    bool presented = false;
+    while (!presented && readPacket(pkt) >= 0) {
+        if (pkt->stream_index == m_videoStreamIndex && sendPacket(pkt) >= 0) {
+            while (receiveFrame()) {
+                const qint64 ts = getFrameTimestampMs(m_frame);
+                // The clock keeps running while we decode
+                const qint64 clockMs = playing ? positionMs + static_cast<qint64>(timer.elapsed() * rate) : positionMs;
+                if (ts < clockMs) continue;
+                if (presentFrame(m_frame, ts)) {
+                    m_position.store(ts);
+                    emit positionChanged(ts);
+                    presented = true;
+                }
+                break;
+            }
+        }
+        av_packet_unref(pkt);
+        // Broken timestamps must not keep us here; the playback loop carries on dropping
+        if (++decodeIterations > kCatchUpMaxIterations || timer.elapsed() > kCatchUpMaxTimeMs) break;
+    }
+    av_packet_free(&pkt);
+}
+
+QSize FFmpegVideoDecoder::desiredOutputSize() const
+{
+    if (!m_codecContext) {
+        return QSize();
+    }
+    const QSize native(m_codecContext->width, m_codecContext->height);
+    const int targetW = m_targetWidth.load();
+    const int targetH = m_targetHeight.load();
+    if (native.isEmpty() || targetW <= 0 || targetH <= 0) {
+        return native;
+    }
+    // Fit to the on-screen size, never upscale. Quantise the scale to eighths so continuous
+    // zooming does not rebuild the scaler and buffers on every step.
+    double fit = std::max(static_cast<double>(targetW) / native.width(),
+                          static_cast<double>(targetH) / native.height());
+    double scale = std::min(1.0, std::ceil(fit * 8.0) / 8.0);
+    return QSize(std::max(2, static_cast<int>(std::lround(native.width() * scale))),
+                 std::max(2, static_cast<int>(std::lround(native.height() * scale))));
+}
+
+bool FFmpegVideoDecoder::ensureConversionSize(const QSize& outputSize)
 {
-    if (!frame || !m_swsContext || !m_frameRGB || !m_codecContext) {
+    if (!m_codecContext || outputSize.isEmpty()) {
+        return false;
+    }
+    if (m_swsContext && outputSize == m_outputSize) {
+        return true;
+    }
+
+    // sws_getCachedContext reuses the existing context when only the destination changes.
+    // AV_PIX_FMT_RGB32 is native-endian 0xAARRGGBB, i.e. QImage::Format_RGB32, which Qt
+    // paints without any further conversion.
+    m_swsContext = sws_getCachedContext(
+        m_swsContext,
+        m_codecContext->width, m_codecContext->height, m_codecContext->pix_fmt,
+        outputSize.width(), outputSize.height(), AV_PIX_FMT_RGB32,
+        SWS_BILINEAR | SWS_ACCURATE_RND, nullptr, nullptr, nullptr
+    );
+    if (!m_swsContext) {
+        m_outputSize = QSize();
+        return false;
+    }
+    m_outputSize = outputSize;
+    return true;
+}
+
+bool FFmpegVideoDecoder::presentFrame(AVFrame* frame, qint64 timestampMs)
+{
+    if (!frame || !m_codecContext || !m_mailbox) {
+        qWarning() << "Invalid state for frame conversion";
+        return false;
+    }
+    // Follow the view: frames are converted straight to the size they are displayed at
+    if (!ensureConversionSize(desiredOutputSize())) {
         qWarning() << "Invalid state for frame conversion";
-        return QImage();
+        return false;
     }
-    
-    // Convert frame to RGBA
+
+    // Convert directly into the mailbox slot. The slot image is reused across frames; it
+    // only reallocates when the output size changes or the GUI still shares its pixels.
+    FrameMailbox::Frame& slot = m_mailbox->writeSlot();
+    if (slot.image.size() != m_outputSize || slot.image.format() != QImage::Format_RGB32) {
+        slot.image = QImage(m_outputSize, QImage::Format_RGB32);
+    }
+    if (slot.image.isNull()) {
+        qWarning() << "Failed to allocate frame image for size:" << m_outputSize;
+        return false;
+    }
+    uint8_t* dstData[4] = { slot.image.bits(), nullptr, nullptr, nullptr };
+    int dstLinesize[4] = { static_cast<int>(slot.image.bytesPerLine()), 0, 0, 0 };
+    MOUFFETTE_TRACE_SCOPE("decoder", "convert");
+    QElapsedTimer conversionTimer;
+    conversionTimer.start();
     if (sws_scale(m_swsContext, frame->data, frame->linesize, 0, m_codecContext->height,
-              m_frameRGB->data, m_frameRGB->linesize) < 0) {
+                  dstData, dstLinesize) < 0) {
         qWarning() << "Frame conversion failed";
-        return QImage();
+        return false;
     }
-    
-    // Create QImage from RGBA data (Format_RGBA8888 matches FFmpeg's AV_PIX_FMT_RGBA)
-    QImage image(m_frameRGB->data[0], m_codecContext->width, m_codecContext->height, 
-                 m_frameRGB->linesize[0], QImage::Format_RGBA8888);
-    
-    // Return a deep copy to avoid issues with FFmpeg buffer reuse
-    return image.copy();
+    const qint64 conversionNs = conversionTimer.nsecsElapsed();
+    m_conversionNs.fetch_add(conversionNs, std::memory_order_relaxed);
+    m_conversionTimeHistogram.recordNs(conversionNs);
+    slot.timestampMs = timestampMs;
+    slot.publishedAtMs = QDateTime::currentMSecsSinceEpoch();
+    // When the playback clock reaches this frame; posters and seeks have no deadline
+    const double rate = m_playbackRate.load();
+    if (m_playbackState.load() == PlaybackState::Playing && m_playbackStartSystemMs > 0 && rate > 0.0) {
+        slot.dueAtMs = m_playbackStartSystemMs + static_cast<qint64>((timestampMs - m_playbackStartVideoMs) / rate);
+        m_publishLatenessHistogram.recordMs(slot.publishedAtMs - slot.dueAtMs);
+        if (m_publishIntervalTimer.isValid()) m_publishIntervalHistogram.recordNs(m_publishIntervalTimer.nsecsElapsed());
+        m_publishIntervalTimer.start();
+    } else {
+        slot.dueAtMs = -1;
+        m_publishIntervalTimer.invalidate();
+    }
+
+    // Only wake the GUI if it already took the previous frame; otherwise its pending
+    // notification will pick up this newer one
+    if (m_mailbox->publish()) {
+        emit frameAvailable();
+    }
+    return true;
 }
 
 qint64 FFmpegVideoDecoder::getFrameTimestampMs(AVFrame* frame)
@@ -758,7 +1010,7 @@ void FFmpegVideoDecoder::updatePlaybackState(PlaybackState newState)
     PlaybackState oldState = m_playbackState.load();
     m_playbackState.store(newState);
     
-    qDebug() << "Playback state changing from" << static_cast<int>(oldState) << "to" << static_cast<int>(newState) 
+    MOUFFETTE_LOG_DEBUG(logDecoder) << "Playback state changing from" << static_cast<int>(oldState) << "to" << static_cast<int>(newState) 
              << "in thread:" << QThread::currentThread() << "timer:" << m_playbackTimer;
     
     // Control timer based on state
@@ -768,8 +1020,11 @@ void FFmpegVideoDecoder::updatePlaybackState(PlaybackState newState)
             // Anchor playback timing to current system time and current video position
             m_playbackStartSystemMs = now;
             m_playbackStartVideoMs = m_position.load();
-            m_playbackTimer->setInterval(static_cast<int>(m_frameInterval));
-            m_playbackTimer->start();
+            // Unpaced playback drives itself from the queued pass below
+            if (m_pacingMode.load() != PacingMode::Unpaced) {
+                m_playbackTimer->setInterval(static_cast<int>(m_frameInterval));
+                m_playbackTimer->start();
+            }
             
             // Force an immediate frame process
             QMetaObject::invokeMethod(this, &FFmpegVideoDecoder::processFrame, Qt::QueuedConnection);
@@ -8,8 +8,11 @@
 #include <QImage>
 #include <QString>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <atomic>
 #include <memory>
+#include "FrameMailbox.h"
+#include "LatencyHistogram.h"
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -32,6 +35,17 @@ public:
         Playing,
         Paused
     };
+    // RealTime presents frames against the wall clock (normal playback). Unpaced presents
+    // every decoded frame as soon as it is converted, for throughput measurements; it pauses
+    // while the item is hidden and resumes on setVisibility(true).
+    // Lockstep is Unpaced without losing frames: the next frame is only decoded once the
+    // consumer took the previous one from the mailbox and called requestNextFrame()
+    // (offline rendering).
+    enum class PacingMode {
+        RealTime,
+        Unpaced,
+        Lockstep
+    };
 
     explicit FFmpegVideoDecoder(QObject* parent = nullptr);
     ~FFmpegVideoDecoder();
@@ -43,22 +57,51 @@ public:
     void stop();
     void setPosition(qint64 positionMs);
     void setPlaybackRate(double rate);
+    void setPacingMode(PacingMode mode);
+    PacingMode pacingMode() const { return m_pacingMode.load(); }
+    // View feedback (thread-safe). While hidden, playback only advances the clock; decoding
+    // resumes from the nearest keyframe once visible again. targetSizePx is the effective
+    // on-screen size in device pixels: frames are converted no larger than this (an empty
+    // size means native resolution).
+    void setVisibility(bool visible, const QSize& targetSizePx = QSize());
 
     // Thread-safe getters
     qint64 duration() const { return m_duration; }
     qint64 position() const { return m_position; }
     PlaybackState playbackState() const { return m_playbackState.load(); }
     bool hasVideo() const { return m_hasVideo; }
-    QSize videoSize() const { return m_videoSize; }
+    // Native (source) frame size; delivered frames may be smaller, see setVisibility()
+    QSize videoSize() const { QMutexLocker locker(&m_stateMutex); return m_videoSize; }
+    bool isVisible() const { return m_visible.load(); }
+    // Latest-frame mailbox the worker publishes into; the consumer keeps its own reference
+    std::shared_ptr<FrameMailbox> frameMailbox() const { return m_mailbox; }
+    // Frames decoded but discarded because the playback clock had already passed them
+    quint64 lateFrameCount() const { return m_lateFrames.load(std::memory_order_relaxed); }
+    // Total time spent converting frames to RGB32 (sws_scale); divide by the mailbox's
+    // publishedCount() for the per-frame cost
+    qint64 conversionTimeNs() const { return m_conversionNs.load(std::memory_order_relaxed); }
+    // Per-frame timing distributions (thread-safe to read):
+    // decode = codec send/receive time per decoded frame, conversion = sws_scale per frame,
+    // publish lateness = published after the playback clock passed the frame,
+    // publish interval = time between frames published during playback
+    const LatencyHistogram& decodeTimeHistogram() const { return m_decodeTimeHistogram; }
+    const LatencyHistogram& conversionTimeHistogram() const { return m_conversionTimeHistogram; }
+    const LatencyHistogram& publishLatenessHistogram() const { return m_publishLatenessHistogram; }
+    const LatencyHistogram& publishIntervalHistogram() const { return m_publishIntervalHistogram; }
+    void resetTimingHistograms();
 
     // Move to dedicated thread
     void moveToWorkerThread();
     // Request a single decoded frame (poster) without starting playback
     void requestFirstFrame();
+    // Lockstep pacing: the consumer took the pending frame, decode the next one (thread-safe)
+    void requestNextFrame();
 
 signals:
     // Emitted from worker thread (use Qt::QueuedConnection)
-    void frameReady(const QImage& frame, qint64 timestampMs);
+    // A new frame is waiting in frameMailbox(). Coalesced: not emitted again until the
+    // consumer has taken the pending frame, so consumers must always consume() on receipt.
+    void frameAvailable();
     void durationChanged(qint64 durationMs);
     void positionChanged(qint64 positionMs);
     void playbackStateChanged(PlaybackState state);
@@ -74,13 +117,16 @@ private slots:
     void performPendingSeek();
 
 private:
+    // Worker thread: run the playback timer unless Unpaced, which drives itself (see processFrame)
+    void applyPacingMode();
+    // Unpaced playback: queue the next processFrame() pass
+    void continueUnpaced();
+
     // FFmpeg context (only accessed from worker thread)
     AVFormatContext* m_formatContext = nullptr;
     AVCodecContext* m_codecContext = nullptr;
     AVFrame* m_frame = nullptr;
-    AVFrame* m_frameRGB = nullptr;
     SwsContext* m_swsContext = nullptr;
-    uint8_t* m_buffer = nullptr;
     int m_videoStreamIndex = -1;
 
     // Playback state (thread-safe)
@@ -89,6 +135,7 @@ private:
     std::atomic<qint64> m_position{0};
     std::atomic<PlaybackState> m_playbackState{PlaybackState::Stopped};
     std::atomic<double> m_playbackRate{1.0};
+    std::atomic<PacingMode> m_pacingMode{PacingMode::RealTime};
     std::atomic<bool> m_hasVideo{false};
     QSize m_videoSize;
     // Do not emit or report positions earlier than this after a seek; -1 disables the guard
@@ -117,11 +164,38 @@ private:
     // One-shot request to decode a single frame for poster/preview without starting playback
     std::atomic<bool> m_serveOneFrame{false};
 
+    // View feedback (written from any thread, read in worker thread)
+    std::atomic<bool> m_visible{true};
+    std::atomic<int> m_targetWidth{0};
+    std::atomic<int> m_targetHeight{0};
+    // Set when playback advanced without decoding; cleared by resyncToKeyframe()
+    bool m_resyncPending = false;
+    // Size of the current RGB32 conversion output (worker thread only)
+    QSize m_outputSize;
+    // Frames are converted straight into the mailbox's write slot
+    std::shared_ptr<FrameMailbox> m_mailbox;
+    std::atomic<quint64> m_lateFrames{0};
+    std::atomic<qint64> m_conversionNs{0};
+    LatencyHistogram m_decodeTimeHistogram;
+    LatencyHistogram m_conversionTimeHistogram;
+    LatencyHistogram m_publishLatenessHistogram;
+    LatencyHistogram m_publishIntervalHistogram;
+    qint64 m_pendingDecodeNs = 0;          // worker thread only
+    QElapsedTimer m_publishIntervalTimer;  // worker thread only
+
     // Helper methods (worker thread only)
     bool openFile(const QString& filePath);
     void closeFile();
+    // av_read_frame() on the open file (traced as demux)
+    int readPacket(AVPacket* packet);
+    // avcodec_send_packet()/avcodec_receive_frame() into m_frame, timed for the decode histogram
+    int sendPacket(AVPacket* packet);
+    bool receiveFrame();
     bool seekToPosition(qint64 positionMs);
-    QImage convertFrameToQImage(AVFrame* frame);
+    bool presentFrame(AVFrame* frame, qint64 timestampMs);
+    QSize desiredOutputSize() const;
+    bool ensureConversionSize(const QSize& outputSize);
+    void resyncToKeyframe(qint64 positionMs);
     void updatePlaybackState(PlaybackState newState);
     qint64 getFrameTimestampMs(AVFrame* frame);
 };
@@ -0,0 +1,82 @@
+#include "FrameClock.h"
+#include "Trace.h"
+#include <QGraphicsView>
+#include <QScreen>
+#include <QList>
+#include <algorithm>
+#include <cmath>
+
+FrameClock::FrameClock(QGraphicsView* view)
+    : QObject(view)
+    , m_view(view)
+{
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &FrameClock::tick);
+    m_elapsed.start();
+    updateInterval();
+}
+
+FrameClock::~FrameClock()
+{
+    m_timer.stop();
+}
+
+void FrameClock::registerClient(FrameClockClient* client)
+{
+    if (!client || m_clients.contains(client)) return;
+    m_clients.append(client);
+    if (client->wantsFrames()) wake();
+}
+
+void FrameClock::unregisterClient(FrameClockClient* client)
+{
+    m_clients.removeAll(client);
+}
+
+void FrameClock::wake()
+{
+    if (m_timer.isActive()) return;
+    // Pick up the current screen's refresh rate each time we leave idle
+    updateInterval();
+    m_timer.start();
+}
+
+void FrameClock::updateInterval()
+{
+    qreal hz = 60.0;
+    if (m_view && m_view->screen()) {
+        const qreal screenHz = m_view->screen()->refreshRate();
+        if (screenHz >= 1.0) hz = screenHz;
+    }
+    m_refreshRateHz = hz;
+    m_timer.setInterval(std::max(1, static_cast<int>(std::floor(1000.0 / hz))));
+}
+
+void FrameClock::tick()
+{
+    MOUFFETTE_TRACE_SCOPE("canvas", "frame clock tick");
+    const qint64 now = m_elapsed.elapsed();
+    QList<QRectF> dirtyRects;
+    bool anyWantsFrames = false;
+
+    // Iterate a snapshot: a client may unregister (e.g. get deleted) while advancing another
+    const QVector<FrameClockClient*> clients = m_clients;
+    for (FrameClockClient* client : clients) {
+        if (!m_clients.contains(client)) continue;
+        if (client->advanceFrame(now)) {
+            const QRectF r = client->frameDirtySceneRect();
+            if (!r.isEmpty()) dirtyRects.append(r);
+        }
+        if (client->wantsFrames()) anyWantsFrames = true;
+    }
+    ++m_tickCount;
+    emit ticked(now);
+
+    // One repaint request per tick for everything that changed
+    if (!dirtyRects.isEmpty() && m_view) {
+        m_view->updateScene(dirtyRects);
+    }
+    if (!anyWantsFrames) {
+        m_timer.stop();
+    }
+}
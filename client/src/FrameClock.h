@@ -0,0 +1,69 @@
+#ifndef FRAMECLOCK_H
+#define FRAMECLOCK_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QRectF>
+#include <QVector>
+
+class QGraphicsView;
+
+/**
+ * Something animated by a FrameClock (video items, overlays...).
+ * All calls happen on the GUI thread.
+ */
+class FrameClockClient {
+public:
+    virtual ~FrameClockClient() = default;
+    // Advance to the given clock time (ms, monotonic). Return true when the client changed
+    // and frameDirtySceneRect() should be repainted this tick.
+    virtual bool advanceFrame(qint64 nowMs) = 0;
+    virtual QRectF frameDirtySceneRect() const = 0;
+    // While no client wants frames the clock stops; FrameClock::wake() restarts it
+    virtual bool wantsFrames() const = 0;
+};
+
+/**
+ * Single canvas-wide animation driver. Ticks at the refresh rate of the view's screen,
+ * advances every registered client and issues one coalesced updateScene() per tick, so
+ * items no longer run their own timers or repaint on their own schedule.
+ */
+class FrameClock : public QObject {
+    Q_OBJECT
+
+public:
+    explicit FrameClock(QGraphicsView* view);
+    ~FrameClock() override;
+
+    void registerClient(FrameClockClient* client);
+    void unregisterClient(FrameClockClient* client);
+    // A client has new work (frame, progress...): make sure the clock is running
+    void wake();
+
+    bool isRunning() const { return m_timer.isActive(); }
+    qreal refreshRateHz() const { return m_refreshRateHz; }
+    quint64 tickCount() const { return m_tickCount; }
+    // Milliseconds on the clock's monotonic timeline (same base as advanceFrame)
+    qint64 nowMs() const { return m_elapsed.elapsed(); }
+
+signals:
+    // Emitted after all clients advanced, before the coalesced repaint is requested
+    void ticked(qint64 nowMs);
+
+private slots:
+    void tick();
+
+private:
+    void updateInterval();
+
+    QPointer<QGraphicsView> m_view;
+    QTimer m_timer;
+    QElapsedTimer m_elapsed;
+    QVector<FrameClockClient*> m_clients;
+    qreal m_refreshRateHz = 60.0;
+    quint64 m_tickCount = 0;
+};
+
+#endif // FRAMECLOCK_H
@@ -0,0 +1,34 @@
+#include "FrameMailbox.h"
+
+bool FrameMailbox::publish()
+{
+    m_slots[m_back].serial = ++m_nextSerial;
+    // Release the slot contents to the consumer and take back whatever sat in the middle
+    const int previous = m_middle.exchange(m_back | FreshBit, std::memory_order_acq_rel);
+    m_back = previous & IndexMask;
+    m_published.fetch_add(1, std::memory_order_relaxed);
+    if (previous & FreshBit) {
+        // Consumer never saw the previous frame; it still has a wake-up pending for it
+        m_overwritten.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+bool FrameMailbox::consume()
+{
+    if (!hasFresh()) {
+        return false;
+    }
+    const int previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+    m_front = previous & IndexMask;
+    m_consumed.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void FrameMailbox::resetStats()
+{
+    m_published.store(0, std::memory_order_relaxed);
+    m_consumed.store(0, std::memory_order_relaxed);
+    m_overwritten.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,70 @@
+#ifndef FRAMEMAILBOX_H
+#define FRAMEMAILBOX_H
+
+#include <QImage>
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * Single-producer / single-consumer "latest frame" mailbox (triple buffer).
+ *
+ * The producer (decoder thread) fills its private back slot and publishes it by swapping
+ * it with the shared middle slot; the consumer (GUI thread) swaps the middle slot into its
+ * private front slot when a fresh frame is available. Neither side ever blocks or waits:
+ * a frame the consumer did not pick up in time is simply replaced by the newer one.
+ *
+ * Slots keep their QImage between rotations so the producer can convert straight into
+ * an already-allocated buffer. Shared via std::shared_ptr so either side may outlive the other.
+ */
+class FrameMailbox {
+public:
+    struct Frame {
+        QImage image;
+        qint64 timestampMs = -1;
+        // Wall clock (ms since epoch) when the producer published it; for latency stats
+        qint64 publishedAtMs = -1;
+        // Wall clock (ms since epoch) at which playback is due to show it; -1 when not
+        // playing (poster, seek preview)
+        qint64 dueAtMs = -1;
+        quint64 serial = 0;
+    };
+
+    FrameMailbox() = default;
+    FrameMailbox(const FrameMailbox&) = delete;
+    FrameMailbox& operator=(const FrameMailbox&) = delete;
+
+    // Producer side (one thread only)
+    Frame& writeSlot() { return m_slots[m_back]; }
+    // Publish the write slot. Returns true when the consumer had already taken the
+    // previous frame, i.e. when it needs to be woken up for this one.
+    bool publish();
+
+    // Consumer side (one thread only)
+    bool hasFresh() const { return (m_middle.load(std::memory_order_acquire) & FreshBit) != 0; }
+    // Take the newest published frame if any; returns true when front() changed
+    bool consume();
+    const Frame& front() const { return m_slots[m_front]; }
+
+    // Statistics (any thread)
+    quint64 publishedCount() const { return m_published.load(std::memory_order_relaxed); }
+    quint64 consumedCount() const { return m_consumed.load(std::memory_order_relaxed); }
+    // Frames replaced before the consumer saw them
+    quint64 overwrittenCount() const { return m_overwritten.load(std::memory_order_relaxed); }
+    void resetStats();
+
+private:
+    static constexpr int IndexMask = 0x3;
+    static constexpr int FreshBit = 0x4;
+
+    Frame m_slots[3];
+    int m_back = 0;                 // producer-owned
+    std::atomic<int> m_middle{1};   // slot index | FreshBit
+    int m_front = 2;                // consumer-owned
+    quint64 m_nextSerial = 0;       // producer-owned
+
+    std::atomic<quint64> m_published{0};
+    std::atomic<quint64> m_consumed{0};
+    std::atomic<quint64> m_overwritten{0};
+};
+
+#endif // FRAMEMAILBOX_H
@@ -0,0 +1,81 @@
+#include "IconAtlas.h"
+#include <QPainter>
+#include <QPaintDevice>
+#include <QtSvg/QSvgRenderer>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const char* const kIconPaths[IconAtlas::IconCount] = {
+    ":/icons/icons/play.svg",
+    ":/icons/icons/pause.svg",
+    ":/icons/icons/stop.svg",
+    ":/icons/icons/loop.svg",
+    ":/icons/icons/volume-on.svg",
+    ":/icons/icons/volume-off.svg",
+};
+}
+
+IconAtlas& IconAtlas::instance()
+{
+    static IconAtlas s_instance;
+    return s_instance;
+}
+
+IconAtlas::IconAtlas()
+{
+    for (int i = 0; i < IconCount; ++i) {
+        m_renderers[i] = std::make_unique<QSvgRenderer>(QString::fromLatin1(kIconPaths[i]));
+        if (!m_renderers[i]->isValid()) {
+            qWarning() << "IconAtlas: failed to load" << kIconPaths[i];
+        }
+    }
+}
+
+IconAtlas::~IconAtlas() = default;
+
+const IconAtlas::Atlas& IconAtlas::atlasFor(int cellPx)
+{
+    auto it = m_atlases.find(cellPx);
+    if (it != m_atlases.end()) return it.value();
+
+    Atlas atlas;
+    atlas.pixmap = QPixmap(cellPx * IconCount, cellPx);
+    atlas.pixmap.fill(Qt::transparent);
+    QPainter p(&atlas.pixmap);
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    for (int i = 0; i < IconCount; ++i) {
+        const QRect cell(i * cellPx, 0, cellPx, cellPx);
+        atlas.cells[i] = cell;
+        QSvgRenderer* renderer = m_renderers[i].get();
+        if (!renderer || !renderer->isValid()) continue;
+        // Aspect-fit the icon inside its square cell
+        QSizeF nat = renderer->defaultSize();
+        if (nat.width() <= 0 || nat.height() <= 0) nat = QSizeF(24, 24);
+        const qreal scale = std::min(cell.width() / nat.width(), cell.height() / nat.height());
+        const QSizeF sz(nat.width() * scale, nat.height() * scale);
+        const QPointF topLeft(cell.x() + (cell.width() - sz.width()) / 2.0,
+                              cell.y() + (cell.height() - sz.height()) / 2.0);
+        renderer->render(&p, QRectF(topLeft, sz));
+    }
+    p.end();
+    return m_atlases.insert(cellPx, atlas).value();
+}
+
+void IconAtlas::drawIcon(QPainter* painter, Icon icon, const QRectF& targetRect)
+{
+    if (!painter || icon < 0 || icon >= IconCount) return;
+    const qreal side = std::min(targetRect.width(), targetRect.height());
+    if (side <= 0.0) return;
+    const qreal dpr = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+    const int cellPx = std::max(1, static_cast<int>(std::round(side * dpr)));
+    const Atlas& atlas = atlasFor(cellPx);
+    // Blit 1:1 in device pixels: the cell maps to exactly cellPx / dpr logical units
+    const qreal logicalSide = cellPx / dpr;
+    const QRectF dst(targetRect.center().x() - logicalSide / 2.0,
+                     targetRect.center().y() - logicalSide / 2.0,
+                     logicalSide, logicalSide);
+    painter->drawPixmap(dst, atlas.pixmap, QRectF(atlas.cells[icon]));
+}
@@ -0,0 +1,59 @@
+#ifndef ICONATLAS_H
+#define ICONATLAS_H
+
+#include <QHash>
+#include <QPixmap>
+#include <QRect>
+#include <QRectF>
+#include <QtGlobal>
+#include <array>
+#include <memory>
+
+class QPainter;
+class QSvgRenderer;
+
+/**
+ * Shared, pre-rasterized media overlay icons.
+ *
+ * Each SVG from resources.qrc is parsed once per process. For every (icon size, device
+ * pixel ratio) pair actually drawn, all icons are rasterized once into a single atlas
+ * pixmap; painting an icon is then a plain sub-rect blit. GUI thread only.
+ */
+class IconAtlas {
+public:
+    enum Icon {
+        Play = 0,
+        Pause,
+        Stop,
+        Loop,
+        VolumeOn,
+        VolumeOff,
+        IconCount
+    };
+
+    static IconAtlas& instance();
+
+    // Draw the icon aspect-fitted and centered in targetRect (painter logical units)
+    void drawIcon(QPainter* painter, Icon icon, const QRectF& targetRect);
+
+    // Number of atlases rasterized so far (one per size / DPR combination)
+    int atlasCount() const { return m_atlases.size(); }
+
+private:
+    IconAtlas();
+    ~IconAtlas();
+    IconAtlas(const IconAtlas&) = delete;
+    IconAtlas& operator=(const IconAtlas&) = delete;
+
+    struct Atlas {
+        QPixmap pixmap;
+        std::array<QRect, IconCount> cells;
+    };
+
+    const Atlas& atlasFor(int cellPx);
+
+    std::array<std::unique_ptr<QSvgRenderer>, IconCount> m_renderers;
+    QHash<int, Atlas> m_atlases; // keyed by square cell size in device pixels (logical size x DPR)
+};
+
+#endif // ICONATLAS_H
@@ -0,0 +1,81 @@
+#include "LatencyHistogram.h"
+#include <QtCore/qalgorithms.h>
+#include <algorithm>
+#include <cmath>
+
+QJsonObject LatencyHistogram::Summary::toJson() const
+{
+    QJsonObject o;
+    o["count"] = static_cast<qint64>(count);
+    o["p50_ms"] = p50Ms;
+    o["p95_ms"] = p95Ms;
+    o["p99_ms"] = p99Ms;
+    o["max_ms"] = maxMs;
+    return o;
+}
+
+int LatencyHistogram::bucketFor(quint64 us)
+{
+    if (us < static_cast<quint64>(SubBuckets)) return static_cast<int>(us);
+    const int exponent = 63 - qCountLeadingZeroBits(us);
+    if (exponent > MaxExponent) return BucketCount - 1;
+    const int sub = static_cast<int>((us >> (exponent - SubBucketBits)) & (SubBuckets - 1));
+    return SubBuckets + (exponent - SubBucketBits) * SubBuckets + sub;
+}
+
+quint64 LatencyHistogram::bucketUpperUs(int bucket)
+{
+    if (bucket < SubBuckets) return static_cast<quint64>(bucket);
+    const int exponent = (bucket - SubBuckets) / SubBuckets + SubBucketBits;
+    const int sub = (bucket - SubBuckets) % SubBuckets;
+    const quint64 width = quint64(1) << (exponent - SubBucketBits);
+    return (quint64(SubBuckets + sub) << (exponent - SubBucketBits)) + width - 1;
+}
+
+void LatencyHistogram::recordUs(qint64 us)
+{
+    us = std::max<qint64>(0, us);
+    m_buckets[bucketFor(static_cast<quint64>(us))].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    qint64 prevMax = m_maxUs.load(std::memory_order_relaxed);
+    while (us > prevMax && !m_maxUs.compare_exchange_weak(prevMax, us, std::memory_order_relaxed)) {
+    }
+}
+
+double LatencyHistogram::percentileMs(double p) const
+{
+    // Sum the buckets rather than trusting m_count: both move while a recorder is running
+    std::array<quint64, BucketCount> counts;
+    quint64 total = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) return 0.0;
+    const quint64 rank = std::max<quint64>(1, static_cast<quint64>(std::ceil(std::clamp(p, 0.0, 1.0) * total)));
+    quint64 seen = 0;
+    const quint64 maxUs = static_cast<quint64>(m_maxUs.load(std::memory_order_relaxed));
+    for (int i = 0; i < BucketCount; ++i) {
+        seen += counts[i];
+        if (seen >= rank) return std::min(bucketUpperUs(i), maxUs) / 1000.0;
+    }
+    return maxUs / 1000.0;
+}
+
+LatencyHistogram::Summary LatencyHistogram::summary() const
+{
+    Summary s;
+    s.count = count();
+    s.p50Ms = percentileMs(0.50);
+    s.p95Ms = percentileMs(0.95);
+    s.p99Ms = percentileMs(0.99);
+    s.maxMs = maxMs();
+    return s;
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto& bucket : m_buckets) bucket.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_maxUs.store(0, std::memory_order_relaxed);
+}
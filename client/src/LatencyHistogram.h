@@ -0,0 +1,60 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QJsonObject>
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+
+/**
+ * Log-bucketed histogram of durations (decode time, lateness, frame intervals...).
+ *
+ * Four buckets per power of two of microseconds (~19% wide, exact below 4 us), so tail
+ * percentiles stay meaningful without storing samples. Recording is a couple of relaxed
+ * atomic increments: one thread may record while others read. Percentiles report the upper
+ * bound of the bucket (never below the true value), capped at the exact maximum.
+ */
+class LatencyHistogram {
+public:
+    struct Summary {
+        quint64 count = 0;
+        double p50Ms = 0.0;
+        double p95Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+        QJsonObject toJson() const;
+    };
+
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    // Negative durations (e.g. a frame that is early rather than late) count as zero
+    void recordUs(qint64 us);
+    void recordNs(qint64 ns) { recordUs(ns / 1000); }
+    void recordMs(qint64 ms) { recordUs(ms * 1000); }
+
+    quint64 count() const { return m_count.load(std::memory_order_relaxed); }
+    double maxMs() const { return m_maxUs.load(std::memory_order_relaxed) / 1000.0; }
+    // p in [0, 1]
+    double percentileMs(double p) const;
+    Summary summary() const;
+    // Not atomic with respect to concurrent recording; a few samples may straddle the reset
+    void reset();
+
+private:
+    static constexpr int SubBucketBits = 2;
+    static constexpr int SubBuckets = 1 << SubBucketBits;
+    // Highest power of two tracked (2^36 us ~ 19 h); longer durations land in the last bucket
+    static constexpr int MaxExponent = 36;
+    static constexpr int BucketCount = SubBuckets + (MaxExponent - SubBucketBits + 1) * SubBuckets;
+
+    static int bucketFor(quint64 us);
+    static quint64 bucketUpperUs(int bucket);
+
+    std::array<std::atomic<quint64>, BucketCount> m_buckets{};
+    std::atomic<quint64> m_count{0};
+    std::atomic<qint64> m_maxUs{0};
+};
+
+#endif // LATENCYHISTOGRAM_H
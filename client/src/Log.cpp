@@ -0,0 +1,226 @@
+#include "Log.h"
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+#include <cstdio>
+#include <thread>
+#include <utility>
+#include <vector>
+
+LogCategory logDecoder("decoder");
+LogCategory logVideo("video");
+LogCategory logNetwork("network");
+LogCategory logMemory("memory");
+
+namespace {
+constexpr int kRingCapacity = 8192;
+
+const char* levelTag(LogLevel level)
+{
+    switch (level) {
+    case LogLevel::Trace: return "T";
+    case LogLevel::Debug: return "D";
+    case LogLevel::Info: return "I";
+    case LogLevel::Warning: return "W";
+    default: return "?";
+    }
+}
+
+bool parseLevel(const QString& text, LogLevel* level)
+{
+    static const QStringList names = {"trace", "debug", "info", "warning", "off"};
+    const int idx = names.indexOf(text.trimmed().toLower());
+    if (idx < 0) return false;
+    *level = static_cast<LogLevel>(idx);
+    return true;
+}
+
+QVector<LogCategory*>& categories()
+{
+    static QVector<LogCategory*> s_categories;
+    return s_categories;
+}
+
+// MOUFFETTE_LOG="decoder=trace,network=debug"; "*" matches every category
+void applyEnvironment(LogCategory* category)
+{
+    const QString spec = qEnvironmentVariable("MOUFFETTE_LOG");
+    for (const QString& entry : spec.split(',', Qt::SkipEmptyParts)) {
+        const QString name = entry.section('=', 0, 0).trimmed();
+        LogLevel level;
+        if (!parseLevel(entry.section('=', 1), &level)) continue;
+        if (name == QLatin1String("*") || name == QLatin1String(category->name())) category->setLevel(level);
+    }
+}
+
+struct Entry {
+    qint64 elapsedUs = 0;
+    const char* category = nullptr;
+    LogLevel level = LogLevel::Info;
+    quintptr threadId = 0;
+    QString text;
+};
+
+// Bounded ring drained by one background thread; producers never wait for I/O
+class Writer {
+public:
+    Writer()
+        : m_ring(kRingCapacity)
+    {
+        m_clock.start();
+        const QString path = qEnvironmentVariable("MOUFFETTE_LOG_FILE");
+        if (!path.isEmpty()) m_file = std::fopen(path.toLocal8Bit().constData(), "a");
+        m_thread = std::thread([this]() { run(); });
+    }
+
+    ~Writer()
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_stopping = true;
+            m_wake.wakeOne();
+        }
+        m_thread.join();
+        if (m_file) std::fclose(m_file);
+    }
+
+    void push(const LogCategory& category, LogLevel level, QString text)
+    {
+        const qint64 us = m_clock.nsecsElapsed() / 1000;
+        const quintptr tid = reinterpret_cast<quintptr>(QThread::currentThreadId());
+        QMutexLocker locker(&m_mutex);
+        if (m_size == kRingCapacity) {
+            ++m_dropped;
+            return;
+        }
+        Entry& e = m_ring[(m_head + m_size) % kRingCapacity];
+        e.elapsedUs = us;
+        e.category = category.name();
+        e.level = level;
+        e.threadId = tid;
+        e.text = std::move(text);
+        ++m_size;
+        m_wake.wakeOne();
+    }
+
+    void flush()
+    {
+        QMutexLocker locker(&m_mutex);
+        while ((m_size > 0 || m_writing) && !m_stopping) m_drained.wait(&m_mutex);
+    }
+
+private:
+    void run()
+    {
+        std::vector<Entry> batch;
+        batch.reserve(256);
+        for (;;) {
+            quint64 dropped = 0;
+            {
+                QMutexLocker locker(&m_mutex);
+                m_writing = false;
+                m_drained.wakeAll();
+                while (m_size == 0 && m_dropped == 0 && !m_stopping) m_wake.wait(&m_mutex);
+                if (m_size == 0 && m_dropped == 0 && m_stopping) return;
+                while (m_size > 0) {
+                    batch.push_back(std::move(m_ring[m_head]));
+                    m_head = (m_head + 1) % kRingCapacity;
+                    --m_size;
+                }
+                dropped = std::exchange(m_dropped, 0);
+                m_writing = true;
+            }
+            // Format and write outside the lock
+            QByteArray out;
+            for (const Entry& e : batch) {
+                out += QByteArray::number(e.elapsedUs / 1.0e6, 'f', 6);
+                out += " [";
+                out += e.category;
+                out += "] ";
+                out += levelTag(e.level);
+                out += " 0x";
+                out += QByteArray::number(static_cast<qulonglong>(e.threadId), 16);
+                out += ' ';
+                out += e.text.toUtf8();
+                out += '\n';
+            }
+            if (dropped > 0) {
+                out += "[log] ";
+                out += QByteArray::number(dropped);
+                out += " records dropped (ring buffer full)\n";
+            }
+            std::fwrite(out.constData(), 1, static_cast<size_t>(out.size()), stderr);
+            std::fflush(stderr);
+            if (m_file) {
+                std::fwrite(out.constData(), 1, static_cast<size_t>(out.size()), m_file);
+                std::fflush(m_file);
+            }
+            batch.clear();
+        }
+    }
+
+    QMutex m_mutex;
+    QWaitCondition m_wake;
+    QWaitCondition m_drained;
+    std::vector<Entry> m_ring;
+    int m_head = 0;
+    int m_size = 0;
+    quint64 m_dropped = 0;
+    bool m_writing = false;
+    bool m_stopping = false;
+    QElapsedTimer m_clock;
+    std::FILE* m_file = nullptr;
+    std::thread m_thread;
+};
+
+Writer& writer()
+{
+    // Started on the first enabled record; drains and joins at exit
+    static Writer s_writer;
+    return s_writer;
+}
+}
+
+LogCategory::LogCategory(const char* name)
+    : m_name(name)
+{
+    categories().append(this);
+    applyEnvironment(this);
+}
+
+Log::Record::Record(const LogCategory& category, LogLevel level)
+    : m_category(category)
+    , m_level(level)
+{
+    m_stream.emplace(&m_text);
+}
+
+Log::Record::~Record()
+{
+    // QDebug writes its buffer into m_text when destroyed
+    m_stream.reset();
+    if (m_text.endsWith(' ')) m_text.chop(1);
+    writer().push(m_category, m_level, std::move(m_text));
+}
+
+bool Log::setLevel(const QString& category, LogLevel level)
+{
+    bool matched = false;
+    for (LogCategory* c : categories()) {
+        if (category == QLatin1String("*") || category == QLatin1String(c->name())) {
+            c->setLevel(level);
+            matched = true;
+        }
+    }
+    return matched;
+}
+
+void Log::flush()
+{
+    writer().flush();
+}
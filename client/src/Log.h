@@ -0,0 +1,85 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <QDebug>
+#include <QString>
+#include <atomic>
+#include <optional>
+
+/**
+ * Categorised logging for hot paths (decoder loop, playback UI, network messages).
+ *
+ *   MOUFFETTE_LOG_DEBUG(logDecoder) << "Decoded frame ts:" << ts;
+ *
+ * - Levels below MOUFFETTE_LOG_MIN_LEVEL (CMake cache variable) are compiled out entirely.
+ * - Otherwise a disabled statement is one relaxed atomic load: operands are not evaluated
+ *   and nothing is formatted. Categories log Info and above by default; enable more at
+ *   runtime with MOUFFETTE_LOG="decoder=trace,network=debug" (or "*=debug") or setLevel().
+ * - Enabled records are formatted on the calling thread and queued in a bounded ring
+ *   buffer; a background thread writes them to stderr (and MOUFFETTE_LOG_FILE if set).
+ *   When the buffer is full, records are dropped and the count is reported.
+ */
+enum class LogLevel : int {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warning = 3,
+    Off = 4
+};
+
+#ifndef MOUFFETTE_LOG_MIN_LEVEL
+#define MOUFFETTE_LOG_MIN_LEVEL 0
+#endif
+
+class LogCategory {
+public:
+    explicit LogCategory(const char* name);
+    const char* name() const { return m_name; }
+    bool isEnabled(LogLevel level) const { return static_cast<int>(level) >= m_level.load(std::memory_order_relaxed); }
+    void setLevel(LogLevel level) { m_level.store(static_cast<int>(level), std::memory_order_relaxed); }
+
+private:
+    const char* m_name;
+    std::atomic<int> m_level{static_cast<int>(LogLevel::Info)};
+};
+
+class Log {
+public:
+    // One log statement; the text is queued when the record goes out of scope
+    class Record {
+    public:
+        Record(const LogCategory& category, LogLevel level);
+        ~Record();
+        Record(const Record&) = delete;
+        Record& operator=(const Record&) = delete;
+        QDebug& stream() { return *m_stream; }
+    private:
+        const LogCategory& m_category;
+        LogLevel m_level;
+        QString m_text;
+        std::optional<QDebug> m_stream;
+    };
+
+    // Category by name ("*" for all); returns false if no category matched
+    static bool setLevel(const QString& category, LogLevel level);
+    // Block until everything queued so far has been written
+    static void flush();
+};
+
+// Hot-path categories
+extern LogCategory logDecoder;  // FFmpeg decoder thread
+extern LogCategory logVideo;    // video items: playback state, frame statistics
+extern LogCategory logNetwork;  // WebSocket connection and messages
+extern LogCategory logMemory;   // media memory budget enforcement
+
+#define MOUFFETTE_LOG(category, level) \
+    for (bool mouffetteLogOn = static_cast<int>(level) >= MOUFFETTE_LOG_MIN_LEVEL && (category).isEnabled(level); \
+         mouffetteLogOn; mouffetteLogOn = false) \
+        Log::Record((category), (level)).stream()
+
+#define MOUFFETTE_LOG_TRACE(category) MOUFFETTE_LOG(category, LogLevel::Trace)
+#define MOUFFETTE_LOG_DEBUG(category) MOUFFETTE_LOG(category, LogLevel::Debug)
+#define MOUFFETTE_LOG_INFO(category) MOUFFETTE_LOG(category, LogLevel::Info)
+#define MOUFFETTE_LOG_WARNING(category) MOUFFETTE_LOG(category, LogLevel::Warning)
+
+#endif // LOG_H
@@ -1,5 +1,17 @@
 #include "MainWindow.h"
 #include "FFmpegVideoDecoder.h"
+#include "FrameClock.h"
+#include "MediaMemoryAccountant.h"
+#include "IconAtlas.h"
+#include "TiledImageSource.h"
+#include "SharedImageStore.h"
+#include "AnimatedImageStore.h"
+#include "PerformanceHud.h"
+#include "Trace.h"
+#include "LatencyHistogram.h"
+#include "Log.h"
+#include "SceneSnapshot.h"
+#include "CompositionRenderer.h"
 #include <QMenuBar>
 #include <QMessageBox>
 #include <QHostInfo>
@@ -37,10 +49,17 @@
 #include <QGraphicsTextItem>
 #include <QGraphicsRectItem>
 #include <QGraphicsPathItem>
-#include <QtSvgWidgets/QGraphicsSvgItem>
-#include <QtSvg/QSvgRenderer>
 #include <QPainterPathStroker>
 #include <QFileInfo>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QFileDialog>
+#include <QInputDialog>
+#include <QProgressDialog>
+#include <QStandardPaths>
 #include <climits>
 #ifdef Q_OS_MACOS
 #include "MacCursorHider.h"
@@ -56,6 +75,11 @@
 #include <QElapsedTimer>
 #include <QDateTime>
 #include <QThreadPool>
+#include <QPointer>
+#include <QImageReader>
+#include <QStyleOptionGraphicsItem>
+#include <memory>
+#include <utility>
 #include <QRunnable>
 #include <QMutex>
 #include <QMutexLocker>
@@ -93,6 +117,30 @@ constexpr qreal Z_SCREENS = -1000.0;
 constexpr qreal Z_MEDIA_BASE = 1.0;
 constexpr qreal Z_REMOTE_CURSOR = 10000.0;
 constexpr qreal Z_SCENE_OVERLAY = 12000.0; // above all scene content
+// Longest side (px) kept for off-screen media evicted by the memory accountant
+constexpr int EVICTED_THUMBNAIL_PX = 256;
+// Images at least this large are shown tiled and decoded lazily instead of loaded whole
+constexpr qint64 TILED_IMAGE_MIN_PIXELS = 40LL * 1000 * 1000;
+constexpr int TILED_IMAGE_MIN_EDGE_PX = 16384;
+// Longest side (px) dropped images are decoded at; zooming in reloads more when needed
+constexpr int DROP_DECODE_MAX_EDGE_PX = 4096;
+// Animations keep every decoded frame (see AnimatedImageStore) up to this size per item;
+// longer or larger ones are streamed through the video decoder instead
+constexpr qint64 ANIMATED_IMAGE_CACHE_MAX_BYTES = 256LL * 1024 * 1024;
+constexpr int ANIMATED_IMAGE_MAX_EDGE_PX = 2048;
+// Gap between items arranged by a multi-file drop, in screen pixels (scaled like media)
+constexpr double DROP_GRID_GAP_PX = 40.0;
+
+// Decodes of imported media. Bounded so a drop of dozens of files leaves cores for the GUI
+// thread and the video decoders; jobs queue in drop order.
+QThreadPool* mediaImportPool() {
+    static QThreadPool* s_pool = [] {
+        auto* pool = new QThreadPool(qApp);
+        pool->setMaxThreadCount(std::clamp(QThread::idealThreadCount() - 1, 1, 4));
+        return pool;
+    }();
+    return s_pool;
+}
 }
 
 // Ensure all fade animations respect the configured duration
@@ -213,10 +261,119 @@ private:
     qreal  m_radius = 0.0;
 };
 
+// Whole video control bar (play/stop/repeat/mute buttons, volume and progress) painted by a
+// single item. Top-level scene item that ignores transformations, so all geometry is in
+// pixels; icons come from the shared IconAtlas instead of per-item SVG items.
+class VideoControlsItem : public QGraphicsItem {
+public:
+    VideoControlsItem() {
+        setFlag(QGraphicsItem::ItemIgnoresTransformations, true);
+        setAcceptedMouseButtons(Qt::NoButton);
+        setZValue(Z_SCENE_OVERLAY);
+    }
+    QRectF boundingRect() const override { return QRectF(0, 0, m_totalWpx, m_rowHpx * 2 + m_gapPx); }
+    void setGeometryPx(int totalWpx, int rowHpx, int gapPx, qreal radiusPx) {
+        if (totalWpx == m_totalWpx && rowHpx == m_rowHpx && gapPx == m_gapPx && radiusPx == m_radiusPx) return;
+        prepareGeometryChange();
+        m_totalWpx = totalWpx; m_rowHpx = rowHpx; m_gapPx = gapPx; m_radiusPx = radiusPx;
+        update();
+    }
+    void setBrushes(const QBrush& base, const QBrush& active) {
+        if (base == m_baseBrush && active == m_activeBrush) return;
+        m_baseBrush = base; m_activeBrush = active; update();
+    }
+    void setPlaying(bool playing) { if (playing != m_playing) { m_playing = playing; update(); } }
+    void setRepeatEnabled(bool on) { if (on != m_repeat) { m_repeat = on; update(); } }
+    void setMuted(bool muted) { if (muted != m_muted) { m_muted = muted; update(); } }
+    void setVolume(qreal v) { v = std::clamp<qreal>(v, 0.0, 1.0); if (v != m_volume) { m_volume = v; update(); } }
+    void setProgress(qreal ratio) {
+        // Treat values extremely close to 1.0 as full-width to avoid leaving a tiny gap
+        ratio = std::clamp<qreal>(ratio, 0.0, 1.0);
+        if (ratio >= 0.999999) ratio = 1.0;
+        if (ratio == m_progress) return;
+        // Only repaint the progress row
+        const qreal oldW = progressFillWidth();
+        m_progress = ratio;
+        if (progressFillWidth() != oldW) update(progressRect());
+    }
+    // Button cells in local px, left to right: play, stop, repeat, mute; then the volume slider
+    QRectF buttonRect(int index) const { return QRectF(index * (m_rowHpx + m_gapPx), 0, m_rowHpx, m_rowHpx); }
+    QRectF volumeRect() const {
+        const qreal x = 4 * (m_rowHpx + m_gapPx);
+        return QRectF(x, 0, std::max<qreal>(0.0, m_totalWpx - x), m_rowHpx);
+    }
+    QRectF progressRect() const { return QRectF(0, m_rowHpx + m_gapPx, m_totalWpx, m_rowHpx); }
+
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem*, QWidget*) override {
+        if (m_rowHpx <= 0 || m_totalWpx <= 0) return;
+        const qreal margin = 2.0;
+        const QColor accent(74, 144, 226);
+        IconAtlas& atlas = IconAtlas::instance();
+        painter->save();
+        painter->setPen(Qt::NoPen);
+        painter->setRenderHint(QPainter::Antialiasing, true);
+        auto drawButton = [&](int index, const QBrush& brush, IconAtlas::Icon icon) {
+            const QRectF r = buttonRect(index);
+            // Clamp radius so it never exceeds half of width/height
+            const qreal rad = std::min({ m_radiusPx, r.width() * 0.5, r.height() * 0.5 });
+            painter->setBrush(brush);
+            if (rad > 0.0) painter->drawRoundedRect(r, rad, rad);
+            else painter->drawRect(r);
+            // Icons occupy 60% of the button
+            const qreal s = 0.6;
+            const QRectF iconRect(r.x() + r.width() * (1 - s) / 2.0, r.y() + r.height() * (1 - s) / 2.0,
+                                  r.width() * s, r.height() * s);
+            atlas.drawIcon(painter, icon, iconRect);
+        };
+        drawButton(0, m_baseBrush, m_playing ? IconAtlas::Pause : IconAtlas::Play);
+        drawButton(1, m_baseBrush, IconAtlas::Stop);
+        drawButton(2, m_repeat ? m_activeBrush : m_baseBrush, IconAtlas::Loop);
+        drawButton(3, m_muted ? m_activeBrush : m_baseBrush, m_muted ? IconAtlas::VolumeOff : IconAtlas::VolumeOn);
+
+        painter->setRenderHint(QPainter::Antialiasing, false);
+        const QRectF vol = volumeRect();
+        painter->setBrush(m_baseBrush);
+        painter->drawRect(vol);
+        const qreal volInnerW = std::max<qreal>(0.0, vol.width() - 2 * margin);
+        if (m_volume > 0.0) {
+            painter->setBrush(accent);
+            painter->drawRect(QRectF(vol.x() + margin, vol.y() + margin, volInnerW * m_volume, m_rowHpx - 2 * margin));
+        }
+        const QRectF prog = progressRect();
+        painter->setBrush(m_baseBrush);
+        painter->drawRect(prog);
+        // Progress fill uses the primary accent color; keep solid for readability over translucent bg
+        const qreal fillW = progressFillWidth();
+        if (fillW > 0.0) {
+            painter->setBrush(accent);
+            painter->drawRect(QRectF(prog.x() + margin, prog.y() + margin, fillW, m_rowHpx - 2 * margin));
+        }
+        painter->restore();
+    }
+private:
+    qreal progressFillWidth() const {
+        const qreal innerW = std::max<qreal>(0.0, m_totalWpx - 2 * 2.0);
+        // Round width to device pixels to avoid sub-pixel truncation artifacts
+        return std::round(innerW * m_progress);
+    }
+    int m_totalWpx = 0;
+    int m_rowHpx = 0;
+    int m_gapPx = 0;
+    qreal m_radiusPx = 0.0;
+    QBrush m_baseBrush = QBrush(QColor(0, 0, 0, 160));
+    QBrush m_activeBrush = QBrush(QColor(0, 0, 0, 160));
+    bool m_playing = false;
+    bool m_repeat = false;
+    bool m_muted = false;
+    qreal m_volume = 0.0;
+    qreal m_progress = 0.0;
+};
+
 // Resizable, movable pixmap item with corner handles; keeps aspect ratio
 class ResizableMediaBase : public QGraphicsItem {
 public:
     virtual ~ResizableMediaBase() override {
+        if (ScreenCanvas* canvas = owningCanvas()) canvas->cancelOverlayLayout(this);
         // If label overlay was reparented to the scene, delete it explicitly
         if (m_labelBg && m_labelBg->parentItem() == nullptr) {
             delete m_labelBg; // also deletes m_labelText child
@@ -259,8 +416,14 @@ public:
     // Applies to: filename background, play/stop/repeat/mute buttons. Excludes: progress & volume bars.
     static void setCornerRadiusOfMediaOverlaysPx(int px) { cornerRadiusOfMediaOverlays = std::max(0, px); }
     static int getCornerRadiusOfMediaOverlaysPx() { return cornerRadiusOfMediaOverlays; }
-    // Public hook for view to relayout the filename label after pan/zoom
-    void requestLabelRelayout() { updateLabelLayout(); }
+    // Overlay layout is deferred: mark this item dirty and let its canvas lay out all dirty
+    // items in one pass. Lays out immediately when the item is not shown in a canvas.
+    void invalidateOverlayLayout() {
+        if (ScreenCanvas* canvas = owningCanvas()) canvas->scheduleOverlayLayout(this);
+        else layoutOverlays();
+    }
+    // Called by the canvas batch pass; subclasses add their own overlays
+    virtual void layoutOverlays() { updateLabelLayout(); }
     // Utility for view: tell if a given item-space pos is on a resize handle
     bool isOnHandleAtItemPos(const QPointF& itemPos) const {
         return hitTestHandle(itemPos) != None;
@@ -319,6 +482,20 @@ public:
         }
     }
 
+    // Logical content size; the item's rect is (0, 0, baseSizePx()) before its transform
+    QSize baseSizePx() const { return m_baseSize; }
+    // Describe this item for a scene snapshot (ScreenCanvas::saveSceneSnapshot). Subclasses
+    // fill the type, source and cached pixels on top of the common geometry; false when the
+    // item cannot be saved.
+    virtual bool captureSnapshot(SceneSnapshot::Item& out) const {
+        out.label = m_filename;
+        out.baseSize = m_baseSize;
+        out.pos = pos();
+        out.scale = scale();
+        out.zValue = zValue();
+        return false;
+    }
+
     QRectF boundingRect() const override {
         QRectF br(0, 0, m_baseSize.width(), m_baseSize.height());
         // Only extend bounding rect for handle hit zones when selected
@@ -394,13 +571,13 @@ protected:
                 m_labelText->setVisible(show);
             }
         }
-        if (change == ItemSelectedHasChanged) {
-            // Keep label properly positioned after selection changes
-            updateLabelLayout();
+        if (change == ItemSceneChange) {
+            // Leaving this canvas: drop any pending batched layout
+            if (ScreenCanvas* canvas = owningCanvas()) canvas->cancelOverlayLayout(this);
         }
-        if (change == ItemTransformHasChanged || change == ItemPositionHasChanged) {
-            // Keep the filename overlay glued during resize/move
-            updateLabelLayout();
+        if (change == ItemSelectedHasChanged || change == ItemTransformHasChanged || change == ItemPositionHasChanged) {
+            // Keep overlays glued after selection changes and during resize/move (batched)
+            invalidateOverlayLayout();
         }
     return QGraphicsItem::itemChange(change, value);
     }
@@ -512,6 +689,32 @@ protected:
         }
     }
 
+    // Whether any part of the item intersects the first view's viewport
+    bool isVisibleInAnyView() const {
+        if (!scene() || scene()->views().isEmpty()) return false;
+        auto *view = scene()->views().first();
+        if (!view || !view->viewport()) return false;
+        
+        QRectF viewportRect = view->viewport()->rect();
+        QRectF sceneRect = view->mapToScene(viewportRect.toRect()).boundingRect();
+        QRectF itemSceneRect = mapToScene(boundingRect()).boundingRect();
+        
+        return sceneRect.intersects(itemSceneRect);
+    }
+
+    // Size of the media content in device pixels in the first view (zoom, item scale and DPR)
+    QSize effectiveDevicePixelSize() const {
+        if (!scene() || scene()->views().isEmpty()) return QSize();
+        QGraphicsView* v = scene()->views().first();
+        if (!v || !v->viewport()) return QSize();
+        const QTransform t = sceneTransform() * v->viewportTransform();
+        const qreal sx = std::hypot(t.m11(), t.m12());
+        const qreal sy = std::hypot(t.m21(), t.m22());
+        const qreal dpr = v->viewport()->devicePixelRatioF();
+        return QSize(std::max(1, static_cast<int>(std::ceil(m_baseSize.width() * sx * dpr))),
+                     std::max(1, static_cast<int>(std::ceil(m_baseSize.height() * sy * dpr))));
+    }
+
     qreal toItemLengthFromPixels(int px) const {
         if (!scene() || scene()->views().isEmpty()) return px; // fallback
         QGraphicsView* v = scene()->views().first();
@@ -523,6 +726,20 @@ protected:
         return px / sx;
     }
 
+    // Canvas is mid zoom/pan: prefer cached or cheaper rendering over exact quality
+    bool isCanvasInteracting() const {
+        const ScreenCanvas* canvas = owningCanvas();
+        return canvas && canvas->isInteracting();
+    }
+    ScreenCanvas* owningCanvas() const {
+        if (!scene()) return nullptr;
+        const QList<QGraphicsView*> views = scene()->views();
+        for (QGraphicsView* v : views) {
+            if (auto* canvas = qobject_cast<ScreenCanvas*>(v)) return canvas;
+        }
+        return nullptr;
+    }
+
     void updateLabelLayout() {
         if (!m_labelBg || !m_labelText) return;
         const bool show = !m_filename.isEmpty() && isSelected();
@@ -588,282 +805,540 @@ int ResizableMediaBase::heightOfMediaOverlays = -1;
 int ResizableMediaBase::cornerRadiusOfMediaOverlays = 6;
 
 // Image media implementation using the shared base
-class ResizablePixmapItem : public ResizableMediaBase {
+class ResizablePixmapItem : public ResizableMediaBase, public MediaMemoryClient {
 public:
-    explicit ResizablePixmapItem(const QPixmap& pm, int visualSizePx, int selectionSizePx, const QString& filename = QString())
-        : ResizableMediaBase(pm.size(), visualSizePx, selectionSizePx, filename), m_pix(pm)
-    {}
+    explicit ResizablePixmapItem(const QPixmap& pm, int visualSizePx, int selectionSizePx, const QString& filename = QString(), const QString& sourcePath = QString())
+        : ResizableMediaBase(pm.size(), visualSizePx, selectionSizePx, filename), m_sourcePath(sourcePath)
+    {
+        watchSharedImages();
+        MediaMemoryAccountant::instance()->registerClient(this);
+        // Shown right away as a private image; hashing large pixels would stall the GUI thread
+        const QImage pixels = pm.toImage();
+        setImage(SharedImageStore::instance()->createUnshared(pm, false, pixels));
+        shareWhenHashed(pixels);
+    }
+    // Placeholder of the image's full size; pixels arrive later via decodeFromSourceAsync()
+    explicit ResizablePixmapItem(const QSize& fullSize, int visualSizePx, int selectionSizePx, const QString& filename, const QString& sourcePath)
+        : ResizableMediaBase(fullSize, visualSizePx, selectionSizePx, filename), m_sourcePath(sourcePath)
+    {
+        watchSharedImages();
+        MediaMemoryAccountant::instance()->registerClient(this);
+    }
+    ~ResizablePixmapItem() override {
+        QObject::disconnect(m_mipsReadyConnection);
+        MediaMemoryAccountant::instance()->unregisterClient(this);
+        // The remaining holders' shares grow
+        SharedImageStore::instance()->assign(m_image, nullptr, this);
+    }
     void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override {
+        MOUFFETTE_TRACE_SCOPE("image", "paint");
         Q_UNUSED(option); Q_UNUSED(widget);
-        if (!m_pix.isNull()) {
-            painter->drawPixmap(QPointF(0,0), m_pix);
+        if (m_image && !m_image->pixmap().isNull()) {
+            // Draw from the mip level closest to (not below) the on-screen size instead of
+            // downsampling the full-resolution pixmap on every repaint
+            const qreal lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+            const qreal dpr = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+            const QPixmap& src = m_image->levelForDeviceWidth(m_baseSize.width() * lod * dpr);
+            // The image may be a reduced copy (memory budget): always cover the full base rect
+            painter->drawPixmap(QRectF(0, 0, m_baseSize.width(), m_baseSize.height()), src, QRectF(src.rect()));
+        } else {
+            // Still decoding
+            painter->fillRect(QRectF(0, 0, m_baseSize.width(), m_baseSize.height()), QColor(40, 40, 40));
         }
         paintSelectionAndLabel(painter);
     }
+    // Called by the canvas after pan/zoom: reload from disk when a reduced copy is shown
+    // larger than it is.
+    void updateMemoryResidency() {
+        if (!m_image || !m_image->isReduced() || m_reloadInFlight || m_sourcePath.isEmpty()) return;
+        if (!isVisibleInAnyView()) return;
+        const QSize need = effectiveDevicePixelSize();
+        const QSize have = m_image->pixmap().size();
+        if (need.width() <= have.width() && need.height() <= have.height()) return;
+        decodeFromSourceAsync(need);
+    }
+    // First decode after insertion: at the resolution currently shown (capped), since
+    // zooming in reloads more through updateMemoryResidency()
+    void decodeForCurrentView() {
+        QSize need = m_baseSize.scaled(DROP_DECODE_MAX_EDGE_PX, DROP_DECODE_MAX_EDGE_PX, Qt::KeepAspectRatio);
+        const QSize onScreen = effectiveDevicePixelSize();
+        if (onScreen.isValid() && onScreen.width() < need.width() && onScreen.height() < need.height()) need = onScreen;
+        decodeFromSourceAsync(need);
+    }
+    // Decode the source file on the import pool, downscaled while decoding when it is larger
+    // than `need` (same aspect as the image). Identical content already decoded by another
+    // item is shared instead. Results are dropped if we are gone.
+    void decodeFromSourceAsync(const QSize& need) {
+        if (m_reloadInFlight || m_sourcePath.isEmpty()) return;
+        m_reloadInFlight = true;
+        std::weak_ptr<bool> alive = m_lifeToken;
+        const QString path = m_sourcePath;
+        if (m_contentKey.isEmpty()) {
+            // Identify the content first (hash of the file bytes), then look it up
+            mediaImportPool()->start([this, alive, path, need]() {
+                QByteArray key = SharedImageStore::hashFile(path);
+                QMetaObject::invokeMethod(qApp, [this, alive, key = std::move(key), need]() {
+                    if (alive.expired()) return;
+                    m_reloadInFlight = false;
+                    if (key.isEmpty()) {
+                        qWarning() << "Failed to read image" << m_sourcePath;
+                        return;
+                    }
+                    m_contentKey = key;
+                    decodeFromSourceAsync(need);
+                }, Qt::QueuedConnection);
+            });
+            return;
+        }
+        if (std::shared_ptr<SharedImage> shared = SharedImageStore::instance()->find(m_contentKey, need)) {
+            m_reloadInFlight = false;
+            setImage(std::move(shared));
+            return;
+        }
+        mediaImportPool()->start([this, alive, path, need]() {
+            MOUFFETTE_TRACE_SCOPE("image", "decode");
+            QImageReader reader(path);
+            const QSize full = reader.size();
+            // Only decode what is needed; a later zoom-in reloads again
+            const bool partial = full.isValid() && need.isValid() && (need.width() < full.width() || need.height() < full.height());
+            if (partial) reader.setScaledSize(full.scaled(need, Qt::KeepAspectRatioByExpanding));
+            QImage img = reader.read();
+            QMetaObject::invokeMethod(qApp, [this, alive, img = std::move(img), partial, path]() {
+                if (alive.expired()) return;
+                m_reloadInFlight = false;
+                if (img.isNull()) {
+                    qWarning() << "Failed to decode image" << path;
+                    return;
+                }
+                setImage(SharedImageStore::instance()->insert(m_contentKey, img, partial));
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    bool captureSnapshot(SceneSnapshot::Item& out) const override {
+        ResizableMediaBase::captureSnapshot(out);
+        out.type = SceneSnapshot::ItemType::Image;
+        out.contentKey = m_contentKey;
+        const bool decoded = m_image && !m_image->pixmap().isNull();
+        if (m_sourcePath.isEmpty()) {
+            // Pasted pixels exist nowhere else: keep them whole
+            if (!decoded) return false;
+            out.preview = m_image->pixmap().toImage();
+            return true;
+        }
+        out.sourcePath = m_sourcePath;
+        out.stampSourceFile();
+        if (decoded) {
+            // Smallest mip level covering the preview size, so saving rarely has to scale
+            QImage preview = m_image->levelForDeviceWidth(SceneSnapshot::PreviewEdgePx).toImage();
+            if (std::max(preview.width(), preview.height()) > SceneSnapshot::PreviewEdgePx) {
+                preview = preview.scaled(SceneSnapshot::PreviewEdgePx, SceneSnapshot::PreviewEdgePx, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            }
+            out.preview = preview;
+        }
+        return true;
+    }
+    QString sourcePath() const { return m_sourcePath; }
+    // Pixels currently held (possibly a reduced copy); null while decoding
+    QImage currentImage() const {
+        return (m_image && !m_image->pixmap().isNull()) ? m_image->pixmap().toImage() : QImage();
+    }
+    // Restored from a snapshot: show the saved preview (or pixels another item already holds)
+    // until updateMemoryResidency() finds the item shown larger than that
+    void restoreFromSnapshot(const QByteArray& contentKey, const QImage& preview) {
+        if (contentKey.isEmpty() || preview.isNull()) return;
+        m_contentKey = contentKey;
+        std::shared_ptr<SharedImage> shared = SharedImageStore::instance()->find(m_contentKey, preview.size());
+        if (!shared) shared = SharedImageStore::instance()->insert(m_contentKey, preview, preview.size() != m_baseSize);
+        setImage(std::move(shared));
+    }
+
+    // MediaMemoryClient: a shared image is accounted in equal parts to the items showing it,
+    // which are all re-accounted when one starts or stops sharing it (SharedImageStore::assign)
+    qint64 mediaMemoryBytes() const override {
+        if (!m_image) return 0;
+        return m_image->bytes() / std::max(1, m_image->holderCount());
+    }
+    bool isMediaOnScreen() const override { return isVisibleInAnyView(); }
+    bool isMediaActive() const override { return false; }
+    qint64 releaseMediaMemory() override {
+        // Without a source file the pixmap cannot be restored later: keep it
+        if (m_sourcePath.isEmpty() || !m_image || m_image->pixmap().isNull()) return 0;
+        const bool onScreen = isVisibleInAnyView();
+        // Other items keep showing it: an on-screen sized private copy would only add bytes
+        if (onScreen && m_image->holderCount() > 1) return 0;
+        const QPixmap& pix = m_image->pixmap();
+        const QSize bound = onScreen ? effectiveDevicePixelSize() : QSize(EVICTED_THUMBNAIL_PX, EVICTED_THUMBNAIL_PX);
+        const QSize target = pix.size().scaled(bound, Qt::KeepAspectRatio);
+        if (target.isEmpty() || target.width() >= pix.width()) return 0;
+        // Only the last holder actually frees the shared image
+        const qint64 released = m_image->holderCount() == 1 ? m_image->bytes() : 0;
+        // Private reduced copy; the shared image is freed once its last user lets go
+        std::shared_ptr<SharedImage> reduced = SharedImageStore::instance()->createUnshared(pix.scaled(target, Qt::KeepAspectRatio, Qt::SmoothTransformation), true);
+        const qint64 added = reduced->bytes();
+        setImage(std::move(reduced));
+        return std::max<qint64>(0, released - added);
+    }
 private:
-    QPixmap m_pix;
+    void setImage(std::shared_ptr<SharedImage> image) {
+        if (image == m_image) return;
+        SharedImageStore::instance()->assign(m_image, std::move(image), this);
+        update();
+    }
+    // Hash pasted pixels on the import pool, then share them (or switch to an identical image
+    // another item already shows)
+    void shareWhenHashed(const QImage& pixels) {
+        std::weak_ptr<bool> alive = m_lifeToken;
+        mediaImportPool()->start([this, alive, pixels]() {
+            QByteArray key = SharedImageStore::hashImage(pixels);
+            QMetaObject::invokeMethod(qApp, [this, alive, key = std::move(key)]() {
+                if (alive.expired() || key.isEmpty() || !m_contentKey.isEmpty()) return;
+                m_contentKey = key;
+                setImage(SharedImageStore::instance()->adopt(m_contentKey, m_image));
+            }, Qt::QueuedConnection);
+        });
+    }
+    // Mip levels are built in the background once per shared image: repaint when ours arrive
+    void watchSharedImages() {
+        m_mipsReadyConnection = QObject::connect(SharedImageStore::instance(), &SharedImageStore::mipsReady,
+                                                 SharedImageStore::instance(), [this](const SharedImage* image) {
+            if (image != m_image.get()) return;
+            MediaMemoryAccountant::instance()->notifyChanged(this);
+            update();
+        });
+    }
+
+    std::shared_ptr<SharedImage> m_image;
+    // Content hash of the source (file bytes or pasted pixels); empty until computed
+    QByteArray m_contentKey;
+    QMetaObject::Connection m_mipsReadyConnection;
+    // Original file, used to restore full resolution after an eviction
+    QString m_sourcePath;
+    bool m_reloadInFlight = false;
+    // Lifetime token for background reloads (checked on the GUI thread)
+    std::shared_ptr<bool> m_lifeToken = std::make_shared<bool>(true);
 };
 
-// Forward declaration for async frame processing
-class ResizableVideoItem;
+// Very large image (panorama, scan, long screenshot) shown through a TiledImageSource: only
+// the visible tiles are decoded, at the level matching the current zoom. Coarser cached
+// tiles stand in while finer ones decode.
+class TiledImageItem : public ResizableMediaBase, public MediaMemoryClient {
+public:
+    TiledImageItem(std::unique_ptr<TiledImageSource> source, int visualSizePx, int selectionSizePx, const QString& filename = QString())
+        : ResizableMediaBase(source->fullSize(), visualSizePx, selectionSizePx, filename), m_source(std::move(source))
+    {
+        // exposedRect limits each paint to the tiles actually being repainted
+        setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+        QObject::connect(m_source.get(), &TiledImageSource::tileReady, m_source.get(), [this](int level, int col, int row) {
+            update(itemRectOfTile(level, col, row));
+            MediaMemoryAccountant::instance()->notifyChanged(this);
+        });
+        // The coarsest level is a single small tile: always have something to show
+        m_source->tile(m_source->levelCount() - 1, 0, 0);
+        MediaMemoryAccountant::instance()->registerClient(this);
+    }
+    ~TiledImageItem() override {
+        MediaMemoryAccountant::instance()->unregisterClient(this);
+    }
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override {
+        MOUFFETTE_TRACE_SCOPE("tiled image", "paint");
+        Q_UNUSED(widget);
+        const QRectF exposed = option->exposedRect.intersected(QRectF(0, 0, m_baseSize.width(), m_baseSize.height()));
+        if (!exposed.isEmpty() && m_source->isValid()) {
+            const qreal lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+            const qreal dpr = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+            const int level = m_source->levelForScale(lod * dpr);
+            const qreal tileItemSize = TiledImageSource::TileSizePx * std::ldexp(1.0, level);
+            const QSize grid = m_source->tileGrid(level);
+            const int c0 = std::clamp(static_cast<int>(std::floor(exposed.left() / tileItemSize)), 0, grid.width() - 1);
+            const int c1 = std::clamp(static_cast<int>(std::floor(exposed.right() / tileItemSize)), 0, grid.width() - 1);
+            const int r0 = std::clamp(static_cast<int>(std::floor(exposed.top() / tileItemSize)), 0, grid.height() - 1);
+            const int r1 = std::clamp(static_cast<int>(std::floor(exposed.bottom() / tileItemSize)), 0, grid.height() - 1);
+            m_source->beginFrame();
+            // Mid-gesture, only paint what is cached; tiles are requested once the view settles
+            const bool interacting = isCanvasInteracting();
+            for (int row = r0; row <= r1; ++row) {
+                for (int col = c0; col <= c1; ++col) {
+                    const QRectF dst = itemRectOfTile(level, col, row);
+                    const QImage img = interacting ? m_source->cachedTile(level, col, row) : m_source->tile(level, col, row);
+                    if (!img.isNull()) painter->drawImage(dst, img);
+                    else paintCoarserTile(painter, level, dst);
+                }
+            }
+        }
+        paintSelectionAndLabel(painter);
+    }
+
+    QString sourcePath() const { return m_source->path(); }
+    bool captureSnapshot(SceneSnapshot::Item& out) const override {
+        ResizableMediaBase::captureSnapshot(out);
+        out.type = SceneSnapshot::ItemType::TiledImage;
+        out.sourcePath = m_source->path();
+        out.stampSourceFile();
+        // The coarsest level is one small tile; restoring it avoids a full-file decode
+        out.preview = m_source->cachedTile(m_source->levelCount() - 1, 0, 0);
+        return true;
+    }
+
+    // MediaMemoryClient
+    qint64 mediaMemoryBytes() const override { return m_source->cachedBytes(); }
+    bool isMediaOnScreen() const override { return isVisibleInAnyView(); }
+    bool isMediaActive() const override { return false; }
+    qint64 releaseMediaMemory() override {
+        const qint64 freed = m_source->trimCache();
+        if (freed > 0) update();
+        return freed;
+    }
+private:
+    QRectF itemRectOfTile(int level, int col, int row) const {
+        const QRect r = m_source->tileRect(level, col, row);
+        const qreal f = std::ldexp(1.0, level);
+        return QRectF(r.x() * f, r.y() * f, r.width() * f, r.height() * f);
+    }
+    // Fill dst (a tile of the given level) from the nearest coarser cached tile
+    void paintCoarserTile(QPainter* painter, int level, const QRectF& dst) const {
+        for (int l = level + 1; l < m_source->levelCount(); ++l) {
+            const qreal f = std::ldexp(1.0, l);
+            const qreal tileItemSize = TiledImageSource::TileSizePx * f;
+            // Tiles are power-of-two aligned, so dst lies within a single coarser tile
+            const int col = static_cast<int>(dst.x() / tileItemSize);
+            const int row = static_cast<int>(dst.y() / tileItemSize);
+            const QImage img = m_source->cachedTile(l, col, row);
+            if (img.isNull()) continue;
+            const QRect tr = m_source->tileRect(l, col, row);
+            const QRectF src(dst.x() / f - tr.x(), dst.y() / f - tr.y(), dst.width() / f, dst.height() / f);
+            painter->drawImage(dst, img, src);
+            return;
+        }
+        painter->fillRect(dst, QColor(40, 40, 40));
+    }
+
+    std::unique_ptr<TiledImageSource> m_source;
+};
 
-// Phase 2: Frame Conversion Worker for async processing
-class FrameConversionWorker : public QRunnable {
+// Animated GIF / APNG / WebP. Every frame is decoded once, at the size shown, and shared
+// with other items of the same file (AnimatedImageStore); the canvas frame clock only picks
+// the frame due, so loops and dozens of copies cost no further decode.
+class AnimatedImageItem : public ResizableMediaBase, public FrameClockClient, public MediaMemoryClient {
 public:
-    FrameConversionWorker(ResizableVideoItem* item, const QImage& image, quint64 serial)
-        : m_itemPtr(reinterpret_cast<uintptr_t>(item)), m_image(image), m_serial(serial)
+    AnimatedImageItem(const QString& sourcePath, const QSize& fullSize, int visualSizePx, int selectionSizePx, const QString& filename = QString())
+        : ResizableMediaBase(fullSize, visualSizePx, selectionSizePx, filename), m_sourcePath(sourcePath)
     {
-        setAutoDelete(true);
+        MediaMemoryAccountant::instance()->registerClient(this);
+    }
+    ~AnimatedImageItem() override {
+        if (m_frameClock) m_frameClock->unregisterClient(this);
+        MediaMemoryAccountant::instance()->unregisterClient(this);
+        // The remaining holders' shares grow
+        AnimatedImageStore::instance()->assign(m_frames, nullptr, this);
+    }
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override {
+        MOUFFETTE_TRACE_SCOPE("animated image", "paint");
+        Q_UNUSED(option); Q_UNUSED(widget);
+        const QRectF target(0, 0, m_baseSize.width(), m_baseSize.height());
+        if (m_frames) {
+            painter->drawImage(target, m_frames->frames()[m_frameIndex]);
+        } else if (!m_poster.isNull()) {
+            // Evicted or restored: first frame until the frames are decoded again
+            painter->drawImage(target, m_poster);
+        } else {
+            painter->fillRect(target, QColor(40, 40, 40));
+        }
+        paintSelectionAndLabel(painter);
     }
 
-    void run() override; // Implementation moved after ResizableVideoItem definition
-    
-    // Global registry to validate item lifetime
-    static QSet<uintptr_t> s_activeItems;
-    static void registerItem(ResizableVideoItem* item) {
-        s_activeItems.insert(reinterpret_cast<uintptr_t>(item));
+    QString sourcePath() const { return m_sourcePath; }
+    bool hasAlpha() const { return m_frames ? m_frames->hasAlpha() : m_poster.hasAlphaChannel(); }
+    // First decode after insertion: at the resolution currently shown (capped)
+    void decodeForCurrentView() {
+        m_onScreen = isVisibleInAnyView();
+        decodeAsync(decodeSizeFor(effectiveDevicePixelSize()));
+    }
+    // Called by the canvas after pan/zoom: pause off-screen, decode again when the frames
+    // were evicted or are shown larger than they were decoded
+    void updateMemoryResidency() {
+        m_onScreen = isVisibleInAnyView();
+        if (!m_onScreen) return;
+        wakeFrameClock();
+        const QSize need = decodeSizeFor(effectiveDevicePixelSize());
+        if (m_frames) {
+            const QSize have = m_frames->size();
+            if (!m_frames->isReduced() || (need.width() <= have.width() && need.height() <= have.height())) return;
+        }
+        decodeAsync(need);
     }
-    static void unregisterItem(ResizableVideoItem* item) {
-        s_activeItems.remove(reinterpret_cast<uintptr_t>(item));
+
+    bool captureSnapshot(SceneSnapshot::Item& out) const override {
+        ResizableMediaBase::captureSnapshot(out);
+        out.type = SceneSnapshot::ItemType::AnimatedImage;
+        out.sourcePath = m_sourcePath;
+        out.stampSourceFile();
+        QImage preview = m_frames ? m_frames->frames().first() : m_poster;
+        if (std::max(preview.width(), preview.height()) > SceneSnapshot::PreviewEdgePx) {
+            preview = preview.scaled(SceneSnapshot::PreviewEdgePx, SceneSnapshot::PreviewEdgePx, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }
+        out.preview = preview;
+        return true;
+    }
+    // Restored from a snapshot: show the saved first frame while the animation decodes
+    void restoreFromSnapshot(const QImage& preview) {
+        m_poster = preview;
+        update();
+    }
+
+    // FrameClockClient: the loop runs on the clock's timeline from the first shown tick
+    bool advanceFrame(qint64 nowMs) override {
+        if (!m_frames || m_frames->frameCount() < 2 || !m_onScreen) return false;
+        if (m_startMs < 0) m_startMs = nowMs;
+        const int index = m_frames->frameIndexAt(nowMs - m_startMs);
+        if (index == m_frameIndex) return false;
+        m_frameIndex = index;
+        return true;
+    }
+    QRectF frameDirtySceneRect() const override {
+        return mapRectToScene(QRectF(0, 0, m_baseSize.width(), m_baseSize.height()));
+    }
+    bool wantsFrames() const override {
+        return m_onScreen && m_frames && m_frames->frameCount() > 1;
+    }
+
+    // MediaMemoryClient: shared frames are accounted in equal parts to the items using them
+    qint64 mediaMemoryBytes() const override {
+        const qint64 frames = m_frames ? m_frames->bytes() / std::max(1, m_frames->holderCount()) : 0;
+        return frames + m_poster.sizeInBytes();
+    }
+    bool isMediaOnScreen() const override { return isVisibleInAnyView(); }
+    bool isMediaActive() const override { return wantsFrames(); }
+    qint64 releaseMediaMemory() override {
+        // On screen the frames are in use; off screen keep a thumbnail and decode again on return
+        if (!m_frames || isVisibleInAnyView()) return 0;
+        // Frames other items still show stay in memory
+        const qint64 freed = (m_frames->holderCount() == 1 ? m_frames->bytes() : 0) + m_poster.sizeInBytes();
+        m_poster = m_frames->frames().first().scaled(EVICTED_THUMBNAIL_PX, EVICTED_THUMBNAIL_PX, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        AnimatedImageStore::instance()->assign(m_frames, nullptr, this);
+        m_frameIndex = 0;
+        update();
+        return std::max<qint64>(0, freed - m_poster.sizeInBytes());
+    }
+protected:
+    QVariant itemChange(GraphicsItemChange change, const QVariant& value) override {
+        if (change == ItemSceneHasChanged) attachToFrameClock();
+        return ResizableMediaBase::itemChange(change, value);
     }
-    
 private:
-    uintptr_t m_itemPtr;
-    QImage m_image;
-    quint64 m_serial;
+    // Shown size, no larger than the file and capped
+    QSize decodeSizeFor(const QSize& onScreen) const {
+        QSize need = m_baseSize;
+        if (std::max(need.width(), need.height()) > ANIMATED_IMAGE_MAX_EDGE_PX) {
+            need = need.scaled(ANIMATED_IMAGE_MAX_EDGE_PX, ANIMATED_IMAGE_MAX_EDGE_PX, Qt::KeepAspectRatio);
+        }
+        if (onScreen.isValid() && onScreen.width() < need.width() && onScreen.height() < need.height()) need = onScreen;
+        return need;
+    }
+    // Frames of the same file already decoded large enough are shared instead. Results are
+    // dropped if we are gone.
+    void decodeAsync(const QSize& need) {
+        if (m_decodeInFlight || m_sourcePath.isEmpty()) return;
+        if (std::shared_ptr<AnimatedImage> shared = AnimatedImageStore::instance()->find(m_sourcePath, need)) {
+            setFrames(std::move(shared));
+            return;
+        }
+        m_decodeInFlight = true;
+        std::weak_ptr<bool> alive = m_lifeToken;
+        const QString path = m_sourcePath;
+        mediaImportPool()->start([this, alive, path, need]() {
+            QString error;
+            std::shared_ptr<AnimatedImage> frames = AnimatedImageStore::decode(path, need, ANIMATED_IMAGE_CACHE_MAX_BYTES, &error);
+            QMetaObject::invokeMethod(qApp, [this, alive, frames = std::move(frames), error, path]() {
+                if (alive.expired()) return;
+                m_decodeInFlight = false;
+                if (!frames) {
+                    qWarning() << "Failed to decode animation" << path << error;
+                    return;
+                }
+                setFrames(AnimatedImageStore::instance()->insert(path, frames));
+            }, Qt::QueuedConnection);
+        });
+    }
+    void setFrames(std::shared_ptr<AnimatedImage> frames) {
+        if (frames == m_frames) return;
+        m_poster = QImage();
+        // Re-accounts us and every other item sharing the old or new frames
+        AnimatedImageStore::instance()->assign(m_frames, std::move(frames), this);
+        // A re-decode at another size keeps the loop's timeline
+        m_frameIndex = std::min(m_frameIndex, m_frames->frameCount() - 1);
+        update();
+        wakeFrameClock();
+    }
+    // Follow the frame clock of the canvas showing our scene (none when off-scene)
+    void attachToFrameClock() {
+        FrameClock* clock = nullptr;
+        if (ScreenCanvas* canvas = owningCanvas()) clock = canvas->frameClock();
+        if (clock == m_frameClock) return;
+        if (m_frameClock) m_frameClock->unregisterClient(this);
+        m_frameClock = clock;
+        if (m_frameClock) m_frameClock->registerClient(this);
+        wakeFrameClock();
+    }
+    void wakeFrameClock() {
+        if (m_frameClock && wantsFrames()) m_frameClock->wake();
+    }
+
+    QString m_sourcePath;
+    std::shared_ptr<AnimatedImage> m_frames;
+    int m_frameIndex = 0;
+    // Clock time of the loop's start; -1 until the first tick showing the frames
+    qint64 m_startMs = -1;
+    QImage m_poster;
+    bool m_onScreen = true;
+    bool m_decodeInFlight = false;
+    QPointer<FrameClock> m_frameClock;
+    // Lifetime token for background decodes (checked on the GUI thread)
+    std::shared_ptr<bool> m_lifeToken = std::make_shared<bool>(true);
 };
 
 // Video media implementation: renders current frame and overlays controls
-class ResizableVideoItem : public ResizableMediaBase {
+class ResizableVideoItem : public ResizableMediaBase, public FrameClockClient, public MediaMemoryClient {
 public:
-    explicit ResizableVideoItem(const QString& filePath, int visualSizePx, int selectionSizePx, const QString& filename = QString())
-        : ResizableMediaBase(QSize(640,360), visualSizePx, selectionSizePx, filename)
+    // primeFirstFrame=false skips decoding the poster frame (restored items bring their own)
+    explicit ResizableVideoItem(const QString& filePath, int visualSizePx, int selectionSizePx, const QString& filename = QString(), bool primeFirstFrame = true)
+        : ResizableMediaBase(QSize(640,360), visualSizePx, selectionSizePx, filename), m_sourcePath(filePath)
     {
-        // Phase 2: Register for async frame conversion
-        FrameConversionWorker::registerItem(this);
-        
     // controlsFadeMs parameter is ignored: fade/animation system removed as obsolete
         
         // Use FFmpeg-based decoder running in a dedicated worker thread
         m_decoder = new FFmpegVideoDecoder();
+        // Frames arrive through the decoder's latest-frame mailbox; we keep our own reference
+        // so the slots stay valid regardless of destruction order
+        m_mailbox = m_decoder->frameMailbox();
         m_decoder->moveToWorkerThread();
         m_decoder->setSource(filePath);
 
     // By default do not autoplay on drop. Request first frame (poster) only.
-    m_primingFirstFrame = true;
-    m_decoder->requestFirstFrame();
-
-        // Connect decoder frame signal to the same processing pipeline
-    QObject::connect(m_decoder, &FFmpegVideoDecoder::frameReady, qApp, [this](const QImage& image, qint64 timestamp){
-            ++m_framesReceived;
-
-            // Skip processing if we're holding the last frame or got an invalid image
-            if (!m_holdLastFrameAtEnd && !image.isNull()) {
-                // Early visibility check - skip processing if not visible
-                if (!isVisibleInAnyView()) {
-                    ++m_framesSkipped;
-                    logFrameStats();
-                    return;
-                }
-
-                // Only process if we're not currently busy with conversion
-                if (!m_conversionBusy.exchange(true)) {
-                    quint64 serial = ++m_frameSerial;
-                    // Start conversion worker directly with the original image
-                    // No need for intermediate copies since QImage uses implicit sharing
-                    auto* worker = new FrameConversionWorker(this, image, serial);
-                    QThreadPool::globalInstance()->start(worker);
-                    ++m_conversionsStarted;
-                    ++m_framesProcessed;
-                } else {
-                    ++m_framesSkipped;
-                }
-
-                // Store latest image for size adoption
-                m_lastImage = image;
-                maybeAdoptImageSize(image);
-
-                if (m_primingFirstFrame && !m_firstFramePrimed) {
-                    m_firstFramePrimed = true;
-                    m_primingFirstFrame = false;
-                    m_controlsLockedUntilReady = false;
-                    // Always show controls when first frame arrives so they're ready when selected
-                    setControlsVisible(true);
-                    updateControlsLayout();
-                    m_lastRepaintMs = 0;
-                    // Set selected state and ensure visibility
-                    setSelected(true);
-                    if (m_controlsBg) m_controlsBg->setVisible(true);
-                    // Force a complete layout update
-                    updateControlsLayout();
-                    update();
-                    return;
-                }
-
-                logFrameStats();
-            }
-
-            if (shouldRepaint()) {
-                m_lastRepaintMs = QDateTime::currentMSecsSinceEpoch();
-                this->update();
+    if (primeFirstFrame) {
+        m_primingFirstFrame = true;
+        m_decoder->requestFirstFrame();
+    }
+    MediaMemoryAccountant::instance()->registerClient(this);
+
+        // New frame in the mailbox: let the canvas frame clock pick it up on its next tick
+    QObject::connect(m_decoder, &FFmpegVideoDecoder::frameAvailable, qApp, [this](){
+            if (m_frameClock) {
+                m_frameClock->wake();
+            } else if (takeMailboxFrame()) {
+                // Not attached to a canvas (yet): present directly
+                update();
             }
     });
         
-    // Controls overlays (ignore transforms so they stay in absolute pixels)
-    // Create as child first, then reparent to scene for scale-invariant positioning
-    m_controlsBg = new QGraphicsRectItem();
-    m_controlsBg->setPen(Qt::NoPen);
-    // Keep container transparent; draw backgrounds on child rects so play is a square, progress is full-width
-    m_controlsBg->setBrush(Qt::NoBrush);
-    m_controlsBg->setZValue(Z_SCENE_OVERLAY);
-    m_controlsBg->setFlag(QGraphicsItem::ItemIgnoresTransformations, true);
-    m_controlsBg->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
-    m_controlsBg->setAcceptedMouseButtons(Qt::NoButton);
-    // No fade: controls start hidden but visible flag added below
-    // Keep as child of the video item so positioning uses item coordinates
-    if (scene()) scene()->addItem(m_controlsBg);
-
-    m_playBtnRectItem = new RoundedRectItem(m_controlsBg);
-    m_playBtnRectItem->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
-    m_playBtnRectItem->setPen(Qt::NoPen);
-    // Square background for the play button, same as filename label
-    m_playBtnRectItem->setBrush(m_labelBg ? m_labelBg->brush() : QBrush(QColor(0,0,0,160)));
-    m_playBtnRectItem->setZValue(Z_SCENE_OVERLAY + 1);
-    m_playBtnRectItem->setFlag(QGraphicsItem::ItemIgnoresTransformations, true);
-    m_playBtnRectItem->setAcceptedMouseButtons(Qt::NoButton);
-
-    m_playIcon = new QGraphicsSvgItem(":/icons/icons/play.svg", m_playBtnRectItem);
-    m_playIcon->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
-    m_playIcon->setZValue(Z_SCENE_OVERLAY + 2);
-    m_playIcon->setFlag(QGraphicsItem::ItemIgnoresTransformations, true);
-    m_playIcon->setAcceptedMouseButtons(Qt::NoButton);
-    m_pauseIcon = new QGraphicsSvgItem(":/icons/icons/pause.svg", m_playBtnRectItem);
-    m_pauseIcon->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
-    m_pauseIcon->setZValue(Z_SCENE_OVERLAY + 2);
-    m_pauseIcon->setFlag(QGraphicsItem::ItemIgnoresTransformations, true);
-    m_pauseIcon->setAcceptedMouseButtons(Qt::NoButton);
-    m_pauseIcon->setVisible(false);
-
-    // Stop button (top row, square)
-    m_stopBtnRectItem = new RoundedRectItem(m_controlsBg);
-    m_stopBtnRectItem->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
-    m_stopBtnRectItem->setPen(Qt::NoPen);
-    m_stopBtnRectItem->setBrush(m_labelBg ? m_labelBg->brush() : QBrush(QColor(0,0,0,160)));
-    m_stopBtnRectItem->setZValue(Z_SCENE_OVERLAY + 1);
-    m_stopBtnRectItem->setFlag(QGraphicsItem::ItemIgnoresTransformations, true);
-    m_stopBtnRectItem->setAcceptedMouseButtons(Qt::NoButton);
-    m_stopIcon = new QGraphicsSvgItem(":/icons/icons/stop.svg", m_stopBtnRectItem);
-    m_stopIcon->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
-    m_stopIcon->setZValue(Z_SCENE_OVERLAY + 2);
-    m_stopIcon->setFlag(QGraphicsItem::ItemIgnoresTransformations, true);
-    m_stopIcon->setAcceptedMouseButtons(Qt::NoButton);
-
-    // Repeat toggle button (top row, square)
-    m_repeatBtnRectItem = new RoundedRectItem(m_controlsBg);
-    m_repeatBtnRectItem->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
-    m_repeatBtnRectItem->setPen(Qt::NoPen);
-    m_repeatBtnRectItem->setBrush(m_labelBg ? m_labelBg->brush() : QBrush(QColor(0,0,0,160)));
-    m_repeatBtnRectItem->setZValue(Z_SCENE_OVERLAY + 1);
-    m_repeatBtnRectItem->setFlag(QGraphicsItem::ItemIgnoresTransformations, true);
-    m_repeatBtnRectItem->setAcceptedMouseButtons(Qt::NoButton);
-    m_repeatIcon = new QGraphicsSvgItem(":/icons/icons/loop.svg", m_repeatBtnRectItem);
-    m_repeatIcon->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
-    m_repeatIcon->setZValue(Z_SCENE_OVERLAY + 2);
-    m_repeatIcon->setFlag(QGraphicsItem::ItemIgnoresTransformations, true);
-    m_repeatIcon->setAcceptedMouseButtons(Qt::NoButton);
-
-    // Mute toggle button (top row, square)
-    m_muteBtnRectItem = new RoundedRectItem(m_controlsBg);
-    m_muteBtnRectItem->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
-    m_muteBtnRectItem->setPen(Qt::NoPen);
-    m_muteBtnRectItem->setBrush(m_labelBg ? m_labelBg->brush() : QBrush(QColor(0,0,0,160)));
-    m_muteBtnRectItem->setZValue(Z_SCENE_OVERLAY + 1);
-    m_muteBtnRectItem->setFlag(QGraphicsItem::ItemIgnoresTransformations, true);
-    m_muteBtnRectItem->setAcceptedMouseButtons(Qt::NoButton);
-    m_muteIcon = new QGraphicsSvgItem(":/icons/icons/volume-on.svg", m_muteBtnRectItem);
-    m_muteIcon->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
-    m_muteIcon->setZValue(Z_SCENE_OVERLAY + 2);
-    m_muteIcon->setFlag(QGraphicsItem::ItemIgnoresTransformations, true);
-    m_muteIcon->setAcceptedMouseButtons(Qt::NoButton);
-    // volume-off asset shown when muted
-    m_muteSlashIcon = new QGraphicsSvgItem(":/icons/icons/volume-off.svg", m_muteBtnRectItem);
-    m_muteSlashIcon->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
-    m_muteSlashIcon->setZValue(Z_SCENE_OVERLAY + 2);
-    m_muteSlashIcon->setFlag(QGraphicsItem::ItemIgnoresTransformations, true);
-    m_muteSlashIcon->setAcceptedMouseButtons(Qt::NoButton);
-
-    // Volume slider (top row, remaining width)
-    m_volumeBgRectItem = new QGraphicsRectItem(m_controlsBg);
-    m_volumeBgRectItem->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
-    m_volumeBgRectItem->setPen(Qt::NoPen);
-    m_volumeBgRectItem->setBrush(m_labelBg ? m_labelBg->brush() : QBrush(QColor(0,0,0,160)));
-    m_volumeBgRectItem->setZValue(Z_SCENE_OVERLAY + 1);
-    m_volumeBgRectItem->setFlag(QGraphicsItem::ItemIgnoresTransformations, true);
-    m_volumeBgRectItem->setAcceptedMouseButtons(Qt::NoButton);
-    m_volumeFillRectItem = new QGraphicsRectItem(m_volumeBgRectItem);
-    m_volumeFillRectItem->setPen(Qt::NoPen);
-    m_volumeFillRectItem->setBrush(QColor(74,144,226));
-    m_volumeFillRectItem->setZValue(Z_SCENE_OVERLAY + 2);
-    m_volumeFillRectItem->setFlag(QGraphicsItem::ItemIgnoresTransformations, true);
-    m_volumeFillRectItem->setAcceptedMouseButtons(Qt::NoButton);
-
-    m_progressBgRectItem = new QGraphicsRectItem(m_controlsBg);
-    m_progressBgRectItem->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
-    m_progressBgRectItem->setPen(Qt::NoPen);
-    // Full-width background for the progress row, same as filename label
-    m_progressBgRectItem->setBrush(m_labelBg ? m_labelBg->brush() : QBrush(QColor(0,0,0,160)));
-    m_progressBgRectItem->setZValue(Z_SCENE_OVERLAY + 1);
-    m_progressBgRectItem->setFlag(QGraphicsItem::ItemIgnoresTransformations, true);
-    m_progressBgRectItem->setAcceptedMouseButtons(Qt::NoButton);
-
-    m_progressFillRectItem = new QGraphicsRectItem(m_progressBgRectItem);
-    m_progressFillRectItem->setPen(Qt::NoPen);
-    // Progress fill uses the primary accent color; keep solid for readability over translucent bg
-    m_progressFillRectItem->setBrush(QColor(74,144,226));
-    m_progressFillRectItem->setZValue(Z_SCENE_OVERLAY + 2);
-    m_progressFillRectItem->setFlag(QGraphicsItem::ItemIgnoresTransformations, true);
-    m_progressFillRectItem->setAcceptedMouseButtons(Qt::NoButton);
-    
-    // Initialize smooth progress timer for real-time updates
-    m_progressTimer = new QTimer();
-    m_progressTimer->setInterval(33); // ~30fps updates for smooth progress (more efficient than 60fps)
+    // Controls overlay: one painted item for the whole bar, kept at scene level with
+    // ItemIgnoresTransformations so it stays in absolute pixels at any zoom
+    m_controls = new VideoControlsItem();
+    if (scene()) scene()->addItem(m_controls);
     
-    // Connect timer to update progress smoothly during playback (uses decoder position)
-    QObject::connect(m_progressTimer, &QTimer::timeout, [this]() {
-        if (m_decoder && m_decoder->playbackState() == FFmpegVideoDecoder::PlaybackState::Playing && 
-            !m_draggingProgress && !m_holdLastFrameAtEnd && !m_seeking && m_durationMs > 0) {
-            qint64 currentPos = m_positionMs;
-            qreal newRatio = static_cast<qreal>(currentPos) / m_durationMs;
-            m_smoothProgressRatio = std::clamp<qreal>(newRatio, 0.0, 1.0);
-            qDebug() << "UI progress timer: pos=" << currentPos << "dur=" << m_durationMs << "ratio=" << m_smoothProgressRatio;
-            updateProgressBar();
-            this->update();
-        }
-    });
     // Initialize controls (they will be shown when selected)
     m_controlsLockedUntilReady = false; // Allow controls immediately
     
-    // Make sure all control elements exist and are properly parented
-    if (m_controlsBg) {
-        m_controlsBg->setVisible(true);
-        
-        // Initialize all control elements visible but with parent opacity 0
-        if (m_playBtnRectItem) m_playBtnRectItem->setVisible(true);
-        if (m_playIcon) m_playIcon->setVisible(true);
-        if (m_pauseIcon) m_pauseIcon->setVisible(false); // Only one play state visible
-        if (m_stopBtnRectItem) m_stopBtnRectItem->setVisible(true);
-        if (m_stopIcon) m_stopIcon->setVisible(true);
-        if (m_repeatBtnRectItem) m_repeatBtnRectItem->setVisible(true);
-        if (m_repeatIcon) m_repeatIcon->setVisible(true);
-        if (m_muteBtnRectItem) m_muteBtnRectItem->setVisible(true);
-        if (m_muteIcon) m_muteIcon->setVisible(true);
-        if (m_muteSlashIcon) m_muteSlashIcon->setVisible(false); // Only one volume state visible
-        if (m_volumeBgRectItem) m_volumeBgRectItem->setVisible(true);
-        if (m_volumeFillRectItem) m_volumeFillRectItem->setVisible(true);
-        if (m_progressBgRectItem) m_progressBgRectItem->setVisible(true);
-        if (m_progressFillRectItem) m_progressFillRectItem->setVisible(true);
-    }
-    
     // Connect FFmpeg decoder signals
     if (m_decoder) {
     QObject::connect(m_decoder, &FFmpegVideoDecoder::durationChanged, qApp, [this](qint64 d){
@@ -871,7 +1346,7 @@ public:
             m_durationMs = d;
             m_positionMs = 0;
             m_smoothProgressRatio = 0.0;
-            qDebug() << "UI: durationChanged ->" << d;
+            MOUFFETTE_LOG_DEBUG(logVideo) << "UI: durationChanged ->" << d;
             updateProgressBar();
             this->update();
     }, Qt::QueuedConnection);
@@ -879,7 +1354,7 @@ public:
     QObject::connect(m_decoder, &FFmpegVideoDecoder::positionChanged, qApp, [this](qint64 p){
             if (m_holdLastFrameAtEnd) return;
             m_positionMs = p;
-            qDebug() << "UI: positionChanged ->" << p << "durationMs:" << m_durationMs;
+            MOUFFETTE_LOG_TRACE(logVideo) << "UI: positionChanged ->" << p << "durationMs:" << m_durationMs;
     }, Qt::QueuedConnection);
 
     QObject::connect(m_decoder, &FFmpegVideoDecoder::playbackStateChanged, qApp, [this](FFmpegVideoDecoder::PlaybackState s){
@@ -890,29 +1365,21 @@ public:
                 bool atEnd = (m_durationMs > 0) && (m_positionMs >= (m_durationMs - nearEpsilon));
                 if (atEnd) {
                     if (m_repeatEnabled) {
-                        if (m_progressTimer) m_progressTimer->stop();
                         m_smoothProgressRatio = 0.0;
                         updateProgressBar();
                         m_decoder->setPosition(0);
                         m_decoder->play();
-                        QTimer::singleShot(10, [this]() {
-                            if (m_progressTimer && m_decoder && m_decoder->playbackState() == FFmpegVideoDecoder::PlaybackState::Playing) {
-                                m_progressTimer->start();
-                            }
-                        });
                     } else {
                         m_holdLastFrameAtEnd = true;
                         if (m_durationMs > 0) m_positionMs = m_durationMs;
                         m_smoothProgressRatio = 1.0;
                         updateProgressBar();
-                        if (m_progressTimer) m_progressTimer->stop();
                         updateControlsLayout();
                         update();
                     }
                 } else {
                     // Not EOF: likely initial stopped state from opening file — ensure UI shows start
                     m_holdLastFrameAtEnd = false;
-                    if (m_progressTimer) m_progressTimer->stop();
                     m_smoothProgressRatio = 0.0;
                     updateProgressBar();
                     updateControlsLayout();
@@ -921,21 +1388,15 @@ public:
             }
             // Update play/pause icons and progress timer for all state changes
             bool isPlaying = (s == FFmpegVideoDecoder::PlaybackState::Playing);
-            if (m_playIcon && m_pauseIcon) {
-                m_playIcon->setVisible(!isPlaying);
-                m_pauseIcon->setVisible(isPlaying);
-            }
-            if (m_progressTimer) {
-                if (isPlaying && !m_seeking && !m_holdLastFrameAtEnd) m_progressTimer->start();
-                else m_progressTimer->stop();
-            }
+            if (m_controls) m_controls->setPlaying(isPlaying);
+            // Progress is advanced by the canvas frame clock while playing
+            if (isPlaying) wakeFrameClock();
     }, Qt::QueuedConnection);
     }
     }
     ~ResizableVideoItem() override {
-    // Phase 2: Unregister from async frame conversion
-    FrameConversionWorker::unregisterItem(this);
-    
+    if (m_frameClock) m_frameClock->unregisterClient(this);
+    MediaMemoryAccountant::instance()->unregisterClient(this);
     // Clean up decoder
     if (m_decoder) {
         QObject::disconnect(m_decoder, nullptr, nullptr, nullptr);
@@ -946,23 +1407,9 @@ public:
     
     // Fade animation removed; nothing to delete here
     // Clean up controls overlay if top-level scene item
-    if (m_controlsBg && m_controlsBg->parentItem() == nullptr) {
-        delete m_controlsBg;
-        m_controlsBg = nullptr;
-        m_playBtnRectItem = nullptr;
-        m_stopBtnRectItem = nullptr;
-        m_repeatBtnRectItem = nullptr;
-        m_muteBtnRectItem = nullptr;
-        m_volumeBgRectItem = nullptr;
-        m_volumeFillRectItem = nullptr;
-        m_progressBgRectItem = nullptr;
-        m_progressFillRectItem = nullptr;
-        m_playIcon = nullptr;
-        m_pauseIcon = nullptr;
-        m_stopIcon = nullptr;
-        m_repeatIcon = nullptr;
-        m_muteIcon = nullptr;
-        m_muteSlashIcon = nullptr;
+    if (m_controls && m_controls->parentItem() == nullptr) {
+        delete m_controls;
+        m_controls = nullptr;
     }
     }
     void togglePlayPause() {
@@ -979,9 +1426,8 @@ public:
         bool currentlyPlaying = (m_decoder->playbackState() == FFmpegVideoDecoder::PlaybackState::Playing);
         if (currentlyPlaying) {
             // User requested pause
-            if (m_progressTimer) m_progressTimer->stop();
             // Update icons immediately
-            if (m_playIcon && m_pauseIcon) { m_playIcon->setVisible(true); m_pauseIcon->setVisible(false); }
+            if (m_controls) m_controls->setPlaying(false);
             // Send pause command asynchronously
             QMetaObject::invokeMethod(qApp, [this]() { if (m_decoder) m_decoder->pause(); }, Qt::QueuedConnection);
         } else {
@@ -993,8 +1439,7 @@ public:
                 m_smoothProgressRatio = 0.0;
                 updateProgressBar();
             }
-            if (m_progressTimer) m_progressTimer->start();
-            if (m_playIcon && m_pauseIcon) { m_playIcon->setVisible(false); m_pauseIcon->setVisible(true); }
+            if (m_controls) m_controls->setPlaying(true);
             // Optimistically mark play requested so layout doesn't immediately flip icons
             m_optPlayRequested = true;
             QTimer::singleShot(300, [this]() { m_optPlayRequested = false; updateControlsLayout(); update(); });
@@ -1010,13 +1455,15 @@ public:
     m_decoder->pause();
     m_decoder->setPosition(0);
     m_positionMs = 0;
-    // Reset progress and stop timer
+    // Reset progress
     m_smoothProgressRatio = 0.0;
     updateProgressBar();
-    if (m_progressTimer) m_progressTimer->stop();
     updateControlsLayout();
     update();
     }
+    void setRepeatEnabled(bool enabled) {
+        if (enabled != m_repeatEnabled) toggleRepeat();
+    }
     void toggleRepeat() {
     m_repeatEnabled = !m_repeatEnabled;
     // Refresh to update button background tint
@@ -1033,9 +1480,8 @@ public:
         if (!m_decoder || m_durationMs <= 0) return;
         r = std::clamp<qreal>(r, 0.0, 1.0);
         m_holdLastFrameAtEnd = false;
-        // Suppress timer updates briefly to avoid flicker back to old position
+        // Suppress clock-driven progress updates briefly to avoid flicker back to old position
         m_seeking = true;
-        if (m_progressTimer) m_progressTimer->stop();
         // Update local UI state immediately
         m_smoothProgressRatio = r;
     m_positionMs = static_cast<qint64>(std::llround(r * m_durationMs));
@@ -1045,18 +1491,67 @@ public:
         // Perform the actual seek
         const qint64 pos = m_positionMs;
         m_decoder->setPosition(pos);
-        // Re-enable timer after a short delay to allow backend to settle
+        // Resume progress updates after a short delay to allow backend to settle
         QTimer::singleShot(30, [this]() {
             m_seeking = false;
-            if (m_progressTimer && m_decoder && m_decoder->playbackState() == FFmpegVideoDecoder::PlaybackState::Playing)
-                m_progressTimer->start();
+            wakeFrameClock();
         });
     }
     void setInitialScaleFactor(qreal f) { m_initialScaleFactor = f; }
+    // Tell the decoder whether we are on screen and how many device pixels we cover, so
+    // off-screen videos stop decoding and small ones are converted at display size.
+    // Cheap to call often: the decoder is only notified when the result changes.
+    void updateDecoderVisibility() {
+        if (!m_decoder) return;
+        const bool visible = isVisibleInAnyView();
+        const QSize target = visible ? effectiveDevicePixelSize() : QSize();
+        if (visible && m_frameEvicted) {
+            // Frame was dropped by the memory accountant while off-screen: decode it again.
+            // While playing, the next presented frame restores it anyway.
+            m_frameEvicted = false;
+            if (m_decoder->playbackState() != FFmpegVideoDecoder::PlaybackState::Playing) {
+                m_decoder->setPosition(m_positionMs);
+            }
+        }
+        if (visible == m_decoderVisible && target == m_decoderTargetSize) return;
+        m_decoderVisible = visible;
+        m_decoderTargetSize = target;
+        m_decoder->setVisibility(visible, target);
+    }
+    QString sourcePath() const { return m_sourcePath; }
+    bool captureSnapshot(SceneSnapshot::Item& out) const override {
+        ResizableMediaBase::captureSnapshot(out);
+        out.type = SceneSnapshot::ItemType::Video;
+        out.sourcePath = m_sourcePath;
+        out.stampSourceFile();
+        // Not saved before the real size is known: the restored item would adopt it again
+        if (!m_adoptedSize) out.baseSize = QSize();
+        QImage poster = !m_lastFrameImage.isNull() ? m_lastFrameImage : m_posterImage;
+        if (!poster.isNull() && std::max(poster.width(), poster.height()) > SceneSnapshot::PreviewEdgePx) {
+            poster = poster.scaled(SceneSnapshot::PreviewEdgePx, SceneSnapshot::PreviewEdgePx, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }
+        out.preview = poster;
+        return true;
+    }
+    // Restored from a snapshot: final size and poster known up front, nothing decoded until played
+    void restoreFromSnapshot(const QSize& baseSize, const QImage& poster) {
+        if (!baseSize.isEmpty()) {
+            prepareGeometryChange();
+            m_baseSize = baseSize;
+            m_adoptedSize = true;
+        }
+        if (!poster.isNull()) {
+            m_posterImage = poster;
+            m_posterImageSet = true;
+            MediaMemoryAccountant::instance()->notifyChanged(this);
+        }
+        update();
+    }
     void setExternalPosterImage(const QImage& img) {
         if (!img.isNull()) {
             m_posterImage = img;
             m_posterImageSet = true;
+            MediaMemoryAccountant::instance()->notifyChanged(this);
             // Adopt the natural size of the poster immediately to avoid any temporary distortion
             if (!m_adoptedSize) {
                 adoptBaseSize(img.size());
@@ -1094,66 +1589,143 @@ public:
             update();
         }
     }
-    // Public helper to refresh overlay positions when the view transform changes
-    void requestOverlayRelayout() { updateControlsLayout(); }
+    // Batched overlay pass: label, controls and the decoder's on-screen size together
+    void layoutOverlays() override {
+        ResizableMediaBase::layoutOverlays();
+        updateControlsLayout();
+        updateDecoderVisibility();
+    }
+
+    // FrameClockClient: called once per canvas tick
+    bool advanceFrame(qint64 nowMs) override {
+        Q_UNUSED(nowMs);
+        const bool frameChanged = takeMailboxFrame();
+        if (m_decoder && m_decoder->playbackState() == FFmpegVideoDecoder::PlaybackState::Playing &&
+            !m_draggingProgress && !m_holdLastFrameAtEnd && !m_seeking && m_durationMs > 0) {
+            const qreal ratio = std::clamp<qreal>(static_cast<qreal>(m_positionMs) / m_durationMs, 0.0, 1.0);
+            if (ratio != m_smoothProgressRatio) {
+                m_smoothProgressRatio = ratio;
+                // The progress fill is its own scene item and schedules its own repaint
+                updateProgressBar();
+            }
+        }
+        return frameChanged;
+    }
+    // MediaMemoryClient
+    qint64 mediaMemoryBytes() const override {
+        return m_lastFrameImage.sizeInBytes() + m_posterImage.sizeInBytes() + m_scaledFrame.sizeInBytes();
+    }
+    bool isMediaOnScreen() const override { return isVisibleInAnyView(); }
+    bool isMediaActive() const override {
+        return m_decoder && m_decoder->playbackState() == FFmpegVideoDecoder::PlaybackState::Playing;
+    }
+    qint64 releaseMediaMemory() override {
+        const qint64 before = mediaMemoryBytes();
+        // The pre-scaled copy is rebuilt on the next paint
+        m_scaledFrame = QImage();
+        m_scaledFrameKey = 0;
+        const bool onScreen = isVisibleInAnyView();
+        // Off-screen: drop the frame, it is decoded again when we come back (see updateDecoderVisibility).
+        // A frame held at EOF is kept: it cannot be re-requested.
+        if (!onScreen && !m_holdLastFrameAtEnd && !m_lastFrameImage.isNull()) {
+            m_lastFrameImage = QImage();
+            m_frameEvicted = true;
+        }
+        // The poster only matters while no frame is shown: keep a thumbnail as placeholder
+        if ((!onScreen || !m_lastFrameImage.isNull()) && !m_posterImage.isNull() &&
+            std::max(m_posterImage.width(), m_posterImage.height()) > EVICTED_THUMBNAIL_PX) {
+            m_posterImage = m_posterImage.scaled(EVICTED_THUMBNAIL_PX, EVICTED_THUMBNAIL_PX, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }
+        return before - mediaMemoryBytes();
+    }
+    QRectF frameDirtySceneRect() const override {
+        return mapRectToScene(QRectF(0, 0, baseWidth(), baseHeight()));
+    }
+    bool wantsFrames() const override {
+        if (m_mailbox && m_mailbox->hasFresh()) return true;
+        return m_decoder && !m_holdLastFrameAtEnd &&
+               m_decoder->playbackState() == FFmpegVideoDecoder::PlaybackState::Playing;
+    }
     
     // Phase 1: Performance tuning methods
     void setFrameProcessingBudget(int ms) { m_frameProcessBudgetMs = std::max(1, ms); }
-    void setRepaintBudget(int ms) { m_repaintBudgetMs = std::max(1, ms); }
     void getFrameStats(int& received, int& processed, int& skipped) const {
         received = m_framesReceived;
         processed = m_framesProcessed;
         skipped = m_framesSkipped;
     }
+    // dropped: frames replaced in the mailbox before the GUI saw them;
+    // conversions: frames converted+published by the decoder / taken by the GUI
     void getFrameStatsExtended(int& received, int& processed, int& skipped, int& dropped, int& conversionsStarted, int& conversionsCompleted) const {
         received = m_framesReceived;
         processed = m_framesProcessed;
         skipped = m_framesSkipped;
-        dropped = m_framesDropped;
-        conversionsStarted = m_conversionsStarted;
-        conversionsCompleted = m_conversionsCompleted;
+        dropped = m_mailbox ? static_cast<int>(m_mailbox->overwrittenCount()) : 0;
+        conversionsStarted = m_mailbox ? static_cast<int>(m_mailbox->publishedCount()) : 0;
+        conversionsCompleted = m_mailbox ? static_cast<int>(m_mailbox->consumedCount()) : 0;
     }
     void resetFrameStats() { 
         m_framesReceived = m_framesProcessed = m_framesSkipped = 0; 
-        m_framesDropped = m_conversionsStarted = m_conversionsCompleted = 0;
-        m_frameSerial = m_lastProcessedSerial = 0;
-    }
-    
-    // Phase 2: Async frame conversion callback
-    void onFrameConversionComplete(QImage convertedImage, quint64 serial) {
-        if (serial <= m_lastProcessedSerial) {
-            ++m_framesDropped;
-            return; // Older frame, discard
+        if (m_mailbox) m_mailbox->resetStats();
+        m_hudSampleMs = -1;
+    }
+    // GUI side: taken from the mailbox after the playback clock passed the frame, and the
+    // time between consecutive frames taken during playback
+    const LatencyHistogram& presentLatenessHistogram() const { return m_presentLatenessHistogram; }
+    const LatencyHistogram& presentIntervalHistogram() const { return m_presentIntervalHistogram; }
+    // Item and decoder distributions as {"name", "decoder": {...}, "presentation": {...}}
+    QJsonObject timingStatsJson() const {
+        QJsonObject decoder;
+        if (m_decoder) {
+            decoder["decode_ms"] = m_decoder->decodeTimeHistogram().summary().toJson();
+            decoder["conversion_ms"] = m_decoder->conversionTimeHistogram().summary().toJson();
+            decoder["lateness_ms"] = m_decoder->publishLatenessHistogram().summary().toJson();
+            decoder["interval_ms"] = m_decoder->publishIntervalHistogram().summary().toJson();
         }
-        
-        m_lastProcessedSerial = serial;
-        m_lastFrameImage = std::move(convertedImage);
-        ++m_conversionsCompleted;
-        m_conversionBusy.store(false);
-        
-        // Debug: Log successful conversion
-        if (m_conversionsCompleted % 30 == 0) {
-            qDebug() << "Frame conversion completed, serial:" << serial << "thread:" << QThread::currentThread();
+        QJsonObject presentation;
+        presentation["lateness_ms"] = m_presentLatenessHistogram.summary().toJson();
+        presentation["interval_ms"] = m_presentIntervalHistogram.summary().toJson();
+        QJsonObject o;
+        o["name"] = m_filename;
+        o["decoder"] = decoder;
+        o["presentation"] = presentation;
+        return o;
+    }
+    void resetTimingStats() {
+        if (m_decoder) m_decoder->resetTimingHistograms();
+        m_presentLatenessHistogram.reset();
+        m_presentIntervalHistogram.reset();
+    }
+    // Pipeline rates for the performance HUD since the previous call (first call only primes)
+    PerformanceHud::VideoStats sampleHudStats(qint64 nowMs) {
+        PerformanceHud::VideoStats stats;
+        stats.name = m_filename;
+        const quint64 published = m_mailbox ? m_mailbox->publishedCount() : 0;
+        const quint64 consumed = m_mailbox ? m_mailbox->consumedCount() : 0;
+        const quint64 overwritten = m_mailbox ? m_mailbox->overwrittenCount() : 0;
+        const quint64 late = m_decoder ? m_decoder->lateFrameCount() : 0;
+        stats.framePending = m_mailbox && m_mailbox->hasFresh();
+        if (m_hudSampleMs >= 0 && nowMs > m_hudSampleMs) {
+            const double seconds = (nowMs - m_hudSampleMs) / 1000.0;
+            const quint64 dPublished = published - m_hudPublished;
+            const quint64 dLost = (overwritten - m_hudOverwritten) + (late - m_hudLate);
+            stats.decodeFps = dPublished / seconds;
+            stats.presentFps = (consumed - m_hudConsumed) / seconds;
+            const quint64 attempted = dPublished + (late - m_hudLate);
+            stats.dropRate = attempted > 0 ? double(dLost) / double(attempted) : 0.0;
         }
-        
-        // Check if there's a newer pending frame to process
-        {
-            QMutexLocker locker(&m_frameMutex);
-            if (!m_pendingImage.isNull() && !m_conversionBusy.exchange(true)) {
-                quint64 newSerial = ++m_frameSerial;
-                QImage pendingCopy = m_pendingImage;
-                m_pendingImage = QImage();
-                auto* worker = new FrameConversionWorker(this, pendingCopy, newSerial);
-                QThreadPool::globalInstance()->start(worker);
-                ++m_conversionsStarted;
-            }
-        }
-        
-        // Throttled repaint - direct update (main thread)
-        if (shouldRepaint()) {
-            m_lastRepaintMs = QDateTime::currentMSecsSinceEpoch();
-            update();
+        if (m_hudLatencyCount > 0) {
+            stats.meanLatencyMs = double(m_hudLatencySumMs) / m_hudLatencyCount;
+            stats.maxLatencyMs = double(m_hudLatencyMaxMs);
         }
+        m_hudSampleMs = nowMs;
+        m_hudPublished = published;
+        m_hudConsumed = consumed;
+        m_hudOverwritten = overwritten;
+        m_hudLate = late;
+        m_hudLatencySumMs = m_hudLatencyMaxMs = 0;
+        m_hudLatencyCount = 0;
+        return stats;
     }
     
     // Expose a helper for view-level control handling
@@ -1192,6 +1764,7 @@ public:
         return false;
     }
     void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override {
+        MOUFFETTE_TRACE_SCOPE("video", "paint");
         Q_UNUSED(option); Q_UNUSED(widget);
     // Painting should not mutate other items; layout is updated on relevant events
         // Draw current frame; otherwise if available, draw poster image; avoid black placeholder to prevent flicker
@@ -1217,10 +1790,10 @@ public:
         };
         if (!m_lastFrameImage.isNull()) {
             QRectF dst = fitRect(br, m_lastFrameImage.size());
-            painter->drawImage(dst, m_lastFrameImage);
+            drawFrameScaledToDevice(painter, dst, m_lastFrameImage);
         } else if (m_posterImageSet && !m_posterImage.isNull()) {
             QRectF dst = fitRect(br, m_posterImage.size());
-            painter->drawImage(dst, m_posterImage);
+            drawFrameScaledToDevice(painter, dst, m_posterImage);
         }
     // Pause icon visibility is controlled elsewhere; avoid layout work during paint
         // Selection/handles and label
@@ -1290,9 +1863,8 @@ public:
     if (!m_controlsLockedUntilReady && isSelected() && m_muteBtnRectItemCoords.contains(event->pos())) { toggleMute(); event->accept(); return; }
     if (!m_controlsLockedUntilReady && isSelected() && m_progRectItemCoords.contains(event->pos())) {
             qreal r = (event->pos().x() - m_progRectItemCoords.left()) / m_progRectItemCoords.width();
-            // Prevent timer from fighting initial press update
+            // Prevent clock-driven progress from fighting initial press update
             m_seeking = true;
-            if (m_progressTimer) m_progressTimer->stop();
             seekToRatio(r);
             m_draggingProgress = true;
             grabMouse();
@@ -1355,15 +1927,16 @@ protected:
         if (change == ItemSceneChange) {
             // When removed from a scene, temporarily hide overlay to avoid dangling in old scene
             if (value.value<QGraphicsScene*>() == nullptr) {
-                if (m_controlsBg) m_controlsBg->setVisible(false);
+                if (m_controls) m_controls->setVisible(false);
             }
         }
         if (change == ItemSceneHasChanged) {
             // Ensure controls overlay belongs to the new scene
-            if (scene() && m_controlsBg && m_controlsBg->scene() != scene()) {
-                if (m_controlsBg->scene()) m_controlsBg->scene()->removeItem(m_controlsBg);
-                scene()->addItem(m_controlsBg);
+            if (scene() && m_controls && m_controls->scene() != scene()) {
+                if (m_controls->scene()) m_controls->scene()->removeItem(m_controls);
+                scene()->addItem(m_controls);
             }
+            attachToFrameClock();
         }
         if (change == ItemSelectedChange) {
             const bool willBeSelected = value.toBool();
@@ -1371,20 +1944,15 @@ protected:
             prepareGeometryChange();
             setControlsVisible(willBeSelected);
         }
-        if (change == ItemSelectedHasChanged) {
-            // Recompute layout after selection toggles
-            updateControlsLayout();
-        }
-        if (change == ItemPositionHasChanged || change == ItemTransformHasChanged) {
-            // Keep overlay glued while moving/resizing from any handle
-            updateControlsLayout();
+        // Selection, move and resize relayout the controls through the base class' batched pass
+        if (change == ItemSceneHasChanged) {
+            updateDecoderVisibility();
         }
         return ResizableMediaBase::itemChange(change, value);
     }
     void onInteractiveGeometryChanged() override {
         // Keep both label and controls overlays glued during interactive resize
-        updateLabelLayout();
-        updateControlsLayout();
+        invalidateOverlayLayout();
         update();
     }
 
@@ -1420,11 +1988,10 @@ protected:
             m_draggingProgress = false;
             m_draggingVolume = false;
             ungrabMouse();
-            // Allow timer to resume after a beat so backend position has caught up
+            // Allow progress to resume after a beat so backend position has caught up
             QTimer::singleShot(30, [this]() {
                 m_seeking = false;
-                if (m_progressTimer && m_decoder && m_decoder->playbackState() == FFmpegVideoDecoder::PlaybackState::Playing)
-                    m_progressTimer->start();
+                wakeFrameClock();
             });
             event->accept();
             return;
@@ -1432,6 +1999,107 @@ protected:
         ResizableMediaBase::mouseReleaseEvent(event);
     }
 private:
+    // Draw img into dst through a copy pre-scaled to the exact device pixels it covers. The copy is
+    // rebuilt only when the frame or the zoom changes, so repaints triggered by hover, selection or
+    // overlays just blit. Rotated/sheared transforms and upscaling go straight to drawImage.
+    void drawFrameScaledToDevice(QPainter* painter, const QRectF& dst, const QImage& img) {
+        const QTransform dt = painter->deviceTransform();
+        if (dt.type() > QTransform::TxScale) {
+            painter->drawImage(dst, img);
+            return;
+        }
+        const QRectF devRect = dt.mapRect(dst);
+        const int x0 = qRound(devRect.left());
+        const int y0 = qRound(devRect.top());
+        const QSize px(qRound(devRect.right()) - x0, qRound(devRect.bottom()) - y0);
+        if (px.isEmpty() || px.width() > img.width() || px.height() > img.height()) {
+            painter->drawImage(dst, img);
+            return;
+        }
+        if (m_scaledFrameKey != img.cacheKey() || m_scaledFrame.size() != px) {
+            if (isCanvasInteracting()) {
+                // Mid-gesture: stretch the cached copy (or the frame) instead of rescaling every
+                // step; the full-quality repaint after the gesture rebuilds it
+                painter->drawImage(dst, m_scaledFrameKey == img.cacheKey() && !m_scaledFrame.isNull() ? m_scaledFrame : img);
+                return;
+            }
+            m_scaledFrame = (px == img.size()) ? img : img.scaled(px, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+            m_scaledFrameKey = img.cacheKey();
+            MediaMemoryAccountant::instance()->notifyChanged(this);
+        }
+        // World transform reset leaves only the device pixel ratio scale: target == device pixels
+        const qreal dpr = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+        painter->save();
+        painter->setWorldTransform(QTransform());
+        painter->drawImage(QRectF(x0 / dpr, y0 / dpr, px.width() / dpr, px.height() / dpr), m_scaledFrame);
+        painter->restore();
+    }
+    // Follow the frame clock of the canvas showing our scene (none when off-scene)
+    void attachToFrameClock() {
+        FrameClock* clock = nullptr;
+        if (scene() && !scene()->views().isEmpty()) {
+            if (auto* canvas = qobject_cast<ScreenCanvas*>(scene()->views().first())) clock = canvas->frameClock();
+        }
+        if (clock == m_frameClock) return;
+        if (m_frameClock) m_frameClock->unregisterClient(this);
+        m_frameClock = clock;
+        if (m_frameClock) m_frameClock->registerClient(this);
+    }
+    void wakeFrameClock() {
+        if (m_frameClock) m_frameClock->wake();
+    }
+    // Take the newest decoded frame, if any. Always consumes so the decoder keeps notifying us.
+    // Returns true when the displayed frame changed.
+    bool takeMailboxFrame() {
+        MOUFFETTE_TRACE_SCOPE("video", "take frame");
+        if (!m_mailbox || !m_mailbox->consume()) return false;
+        ++m_framesReceived;
+        const FrameMailbox::Frame& frame = m_mailbox->front();
+        if (frame.publishedAtMs >= 0) {
+            const qint64 latency = std::max<qint64>(0, QDateTime::currentMSecsSinceEpoch() - frame.publishedAtMs);
+            m_hudLatencySumMs += latency;
+            m_hudLatencyMaxMs = std::max(m_hudLatencyMaxMs, latency);
+            ++m_hudLatencyCount;
+        }
+        if (frame.dueAtMs >= 0) {
+            m_presentLatenessHistogram.recordMs(QDateTime::currentMSecsSinceEpoch() - frame.dueAtMs);
+            if (m_presentIntervalTimer.isValid()) m_presentIntervalHistogram.recordNs(m_presentIntervalTimer.nsecsElapsed());
+            m_presentIntervalTimer.start();
+        } else {
+            // Poster or seek preview: not part of a playback cadence
+            m_presentIntervalTimer.invalidate();
+        }
+
+        // Hold the last frame at EOF until the next user action
+        if (m_holdLastFrameAtEnd || frame.image.isNull()) {
+            ++m_framesSkipped;
+            return false;
+        }
+        // Shares the slot's pixels; released on the next frame, before the slot is rewritten
+        m_lastFrameImage = frame.image;
+        m_frameEvicted = false;
+        MediaMemoryAccountant::instance()->notifyChanged(this);
+        ++m_framesProcessed;
+        maybeAdoptImageSize(frame.image);
+
+        if (m_primingFirstFrame && !m_firstFramePrimed) {
+            m_firstFramePrimed = true;
+            m_primingFirstFrame = false;
+            m_controlsLockedUntilReady = false;
+            // Always show controls when first frame arrives so they're ready when selected
+            setControlsVisible(true);
+            // Set selected state and ensure visibility
+            setSelected(true);
+            if (m_controls) m_controls->setVisible(true);
+            // Force a complete layout update
+            updateControlsLayout();
+            update();
+            return true;
+        }
+
+        logFrameStats();
+        return true;
+    }
     void maybeAdoptFrameSize(const QVideoFrame& f) {
         if (m_adoptedSize) return;
         if (!f.isValid()) return;
@@ -1454,48 +2122,15 @@ private:
         const QPointF newTopLeftScene = oldCenterScene - QPointF(sz.width() * m_initialScaleFactor / 2.0,
                                                                  sz.height() * m_initialScaleFactor / 2.0);
         setPos(newTopLeftScene);
+        updateDecoderVisibility();
         update();
     }
     void setControlsVisible(bool show) {
+        if (!m_controls) return;
         const bool allow = show && !m_controlsLockedUntilReady;
-        // When making controls visible we avoid forcing play/pause icon state
-        // because that can race with optimistic UI updates (user clicked play
-        // before the decoder state settled) and cause a brief flicker.  On
-        // hide, explicitly hide all children including icons.
-        auto setChildrenVisible = [this](bool vis){
-            if (m_playBtnRectItem) m_playBtnRectItem->setVisible(vis);
-            // Do NOT force play/pause icon visibility when showing controls;
-            // let updateControlsLayout() decide the correct icon based on
-            // playback state. When hiding, ensure the icons are hidden.
-            if (!vis) {
-                if (m_playIcon) m_playIcon->setVisible(false);
-                if (m_pauseIcon) m_pauseIcon->setVisible(false);
-            }
-            if (m_stopBtnRectItem) m_stopBtnRectItem->setVisible(vis);
-            if (m_stopIcon) m_stopIcon->setVisible(vis);
-            if (m_repeatBtnRectItem) m_repeatBtnRectItem->setVisible(vis);
-            if (m_repeatIcon) m_repeatIcon->setVisible(vis);
-            if (m_muteBtnRectItem) m_muteBtnRectItem->setVisible(vis);
-            if (m_muteIcon) m_muteIcon->setVisible(vis);
-            if (m_muteSlashIcon) m_muteSlashIcon->setVisible(vis && false); // FFmpeg decoder audio not managed here
-            if (m_volumeBgRectItem) m_volumeBgRectItem->setVisible(vis);
-            if (m_volumeFillRectItem) m_volumeFillRectItem->setVisible(vis);
-            if (m_progressBgRectItem) m_progressBgRectItem->setVisible(vis);
-            if (m_progressFillRectItem) m_progressFillRectItem->setVisible(vis);
-        };
-    if (!m_controlsBg) return;
-        if (allow) {
-            m_controlsBg->setVisible(true);
-            m_controlsBg->setZValue(12000.0); // above everything
-            setChildrenVisible(true);
-            // Instantly show controls (fade system removed)
-            m_controlsBg->setOpacity(1.0);
-        } else {
-            // Instantly hide controls (fade system removed)
-            m_controlsBg->setOpacity(0.0);
-            m_controlsBg->setVisible(false);
-            setChildrenVisible(false);
-        }
+        // The play/pause glyph is not forced here: updateControlsLayout() decides it from the
+        // playback state, which avoids flicker racing optimistic UI updates
+        m_controls->setVisible(allow);
     }
     void updateControlsLayout() {
         if (!scene() || scene()->views().isEmpty()) return;
@@ -1545,101 +2180,38 @@ private:
     QPointF ctrlTopLeftScene = v->viewportTransform().inverted().map(ctrlTopLeftView);
         QPointF ctrlTopLeftItem = mapFromScene(ctrlTopLeftScene);
 
-        // Background tall enough to hold two rows (play above, progress below) with inner gap
-        if (m_controlsBg) {
-            m_controlsBg->setRect(0, 0, totalWpx, rowHpx * 2 + gapPx);
+        // Two rows (buttons and volume above, progress below) with inner gap, painted by one item
+        if (m_controls) {
+            m_controls->setGeometryPx(totalWpx, rowHpx, gapPx, ResizableMediaBase::getCornerRadiusOfMediaOverlaysPx());
+            m_controls->setBrushes(baseBrush, activeBrush);
             // Controls are a top-level scene item; place in scene coords
-            m_controlsBg->setPos(ctrlTopLeftScene);
+            m_controls->setPos(ctrlTopLeftScene);
         }
 
-        // Compute x-positions with uniform gaps (in the local px space of m_controlsBg)
+        // Compute x-positions with uniform gaps (in the local px space of the controls item)
         const qreal x0 = 0;
         const qreal x1 = x0 + playWpx + buttonGapPx;
         const qreal x2 = x1 + stopWpx + buttonGapPx;
         const qreal x3 = x2 + repeatWpx + buttonGapPx;
         const qreal x4 = x3 + muteWpx + buttonGapPx;
 
-        if (m_playBtnRectItem) {
-            m_playBtnRectItem->setRect(0, 0, playWpx, rowHpx); m_playBtnRectItem->setPos(x0, 0);
-            m_playBtnRectItem->setRadius(ResizableMediaBase::getCornerRadiusOfMediaOverlaysPx());
-            m_playBtnRectItem->setBrush(baseBrush);
-        }
-        if (m_stopBtnRectItem) {
-            m_stopBtnRectItem->setRect(0, 0, stopWpx, rowHpx); m_stopBtnRectItem->setPos(x1, 0);
-            m_stopBtnRectItem->setRadius(ResizableMediaBase::getCornerRadiusOfMediaOverlaysPx());
-            m_stopBtnRectItem->setBrush(baseBrush);
-        }
-        if (m_repeatBtnRectItem) {
-            m_repeatBtnRectItem->setRect(0, 0, repeatWpx, rowHpx); m_repeatBtnRectItem->setPos(x2, 0);
-            m_repeatBtnRectItem->setRadius(ResizableMediaBase::getCornerRadiusOfMediaOverlaysPx());
-            m_repeatBtnRectItem->setBrush(m_repeatEnabled ? activeBrush : baseBrush);
-        }
-        if (m_muteBtnRectItem) {
-            m_muteBtnRectItem->setRect(0, 0, muteWpx, rowHpx); m_muteBtnRectItem->setPos(x3, 0);
-            m_muteBtnRectItem->setRadius(ResizableMediaBase::getCornerRadiusOfMediaOverlaysPx());
-            bool muted = false;
-            m_muteBtnRectItem->setBrush(muted ? activeBrush : baseBrush);
-        }
-        if (m_volumeBgRectItem) { m_volumeBgRectItem->setRect(0, 0, volumeWpx, rowHpx); m_volumeBgRectItem->setPos(x4, 0); }
-        if (m_volumeFillRectItem) {
-            const qreal margin = 2.0;
-            qreal vol = 0.0;
-            const qreal innerW = std::max<qreal>(0.0, volumeWpx - 2*margin);
-            m_volumeFillRectItem->setRect(margin, margin, innerW * vol, rowHpx - 2*margin);
-        }
-        if (m_progressBgRectItem) {
-            // Second row, spans left to right under play button, with a gap
-            m_progressBgRectItem->setRect(0, 0, progWpx, rowHpx);
-            m_progressBgRectItem->setPos(0, rowHpx + gapPx);
-        }
-        if (m_progressFillRectItem) {
-            // Use the smoothly animated ratio instead of direct calculation
+        bool isPlaying = (m_decoder && m_decoder->playbackState() == FFmpegVideoDecoder::PlaybackState::Playing);
+        if (m_holdLastFrameAtEnd) isPlaying = false;
+        if (!m_repeatEnabled && m_durationMs > 0 && (m_positionMs + 30 >= m_durationMs)) isPlaying = false;
+        if (m_controls) {
+            m_controls->setPlaying(isPlaying || m_optPlayRequested);
+            m_controls->setRepeatEnabled(m_repeatEnabled);
+            m_controls->setMuted(false); // audio handled separately
+            m_controls->setVolume(0.0);
+            // Use the smoothly animated ratio unless the user is dragging the progress bar
             if (!m_draggingProgress) {
                 updateProgressBar(); // This uses m_smoothProgressRatio
             } else {
-                qreal ratio = (m_durationMs > 0) ? (static_cast<qreal>(m_positionMs) / m_durationMs) : 0.0;
-                ratio = std::clamp<qreal>(ratio, 0.0, 1.0);
-                const qreal margin = 2.0;
-                const qreal innerW = std::max<qreal>(0.0, progWpx - 2*margin);
-                if (ratio >= 0.999999) ratio = 1.0;
-                qreal w = innerW * ratio;
-                qreal w_rounded = std::round(w);
-                m_progressFillRectItem->setRect(margin, margin, w_rounded, rowHpx - 2*margin);
+                const qreal ratio = (m_durationMs > 0) ? (static_cast<qreal>(m_positionMs) / m_durationMs) : 0.0;
+                m_controls->setProgress(ratio);
             }
         }
 
-        // Update SVG icon placement, toggle variants (target sizes are in local px of bg/buttons)
-        auto placeSvg = [](QGraphicsSvgItem* svg, qreal targetW, qreal targetH) {
-            if (!svg) return;
-            QSizeF nat = svg->renderer() ? svg->renderer()->defaultSize() : QSizeF(24,24);
-            if (nat.width() <= 0 || nat.height() <= 0) nat = svg->boundingRect().size();
-            if (nat.width() <= 0 || nat.height() <= 0) nat = QSizeF(24,24);
-            const qreal scale = std::min(targetW / nat.width(), targetH / nat.height()) * 0.6; // 60% of button area
-            svg->setScale(scale);
-            const qreal x = (targetW - nat.width()*scale) / 2.0;
-            const qreal y = (targetH - nat.height()*scale) / 2.0;
-            svg->setPos(x, y);
-        };
-    bool isPlaying = (m_decoder && m_decoder->playbackState() == FFmpegVideoDecoder::PlaybackState::Playing);
-        if (m_holdLastFrameAtEnd) isPlaying = false;
-        if (!m_repeatEnabled && m_durationMs > 0 && (m_positionMs + 30 >= m_durationMs)) isPlaying = false;
-        if (m_playIcon && m_pauseIcon) {
-            bool displayPlaying = isPlaying || m_optPlayRequested;
-            m_playIcon->setVisible(!displayPlaying);
-            m_pauseIcon->setVisible(displayPlaying);
-            placeSvg(m_playIcon, playWpx, rowHpx);
-            placeSvg(m_pauseIcon, playWpx, rowHpx);
-        }
-        placeSvg(m_stopIcon, stopWpx, rowHpx);
-        placeSvg(m_repeatIcon, repeatWpx, rowHpx);
-        bool muted = false; // audio handled separately
-        if (m_muteIcon && m_muteSlashIcon) {
-            m_muteIcon->setVisible(!muted);
-            m_muteSlashIcon->setVisible(muted);
-            placeSvg(m_muteIcon, muteWpx, rowHpx);
-            placeSvg(m_muteSlashIcon, muteWpx, rowHpx);
-        }
-
         // Store item-space rects for hit testing (convert px extents to item units)
         const qreal rowHItem = toItemLengthFromPixels(rowHpx);
         const qreal playWItem = toItemLengthFromPixels(playWpx);
@@ -1670,6 +2242,8 @@ private:
     qint64 m_durationMs = 0;
     qint64 m_positionMs = 0;
     // First-frame priming state
+    // File being played (kept for scene snapshots)
+    QString m_sourcePath;
     bool m_primingFirstFrame = false;
     bool m_firstFramePrimed = false;
     bool m_savedMuted = false;
@@ -1678,22 +2252,8 @@ private:
     // Optional poster image from metadata to avoid initial black frame
     QImage m_posterImage;
     bool m_posterImageSet = false;
-    // Floating controls (absolute px)
-    QGraphicsRectItem* m_controlsBg = nullptr;
-    RoundedRectItem* m_playBtnRectItem = nullptr;
-    QGraphicsSvgItem* m_playIcon = nullptr; // play triangle
-    QGraphicsSvgItem* m_pauseIcon = nullptr; // pause bars
-    RoundedRectItem* m_stopBtnRectItem = nullptr;
-    QGraphicsSvgItem* m_stopIcon = nullptr;
-    RoundedRectItem* m_repeatBtnRectItem = nullptr;
-    QGraphicsSvgItem* m_repeatIcon = nullptr; // currently unused visual, keep for symmetry
-    RoundedRectItem* m_muteBtnRectItem = nullptr;
-    QGraphicsSvgItem* m_muteIcon = nullptr; // volume on
-    QGraphicsSvgItem* m_muteSlashIcon = nullptr; // volume off
-    QGraphicsRectItem* m_volumeBgRectItem = nullptr;
-    QGraphicsRectItem* m_volumeFillRectItem = nullptr;
-    QGraphicsRectItem* m_progressBgRectItem = nullptr;
-    QGraphicsRectItem* m_progressFillRectItem = nullptr;
+    // Floating controls (absolute px), painted as a single item
+    VideoControlsItem* m_controls = nullptr;
     bool m_adoptedSize = false;
     qreal m_initialScaleFactor = 1.0;
     // Cached item-space rects for hit-testing
@@ -1709,8 +2269,7 @@ private:
     bool m_draggingVolume = false;
     // Hold last frame after EndOfMedia until next user action
     bool m_holdLastFrameAtEnd = false;
-    // Smooth progress updates
-    QTimer* m_progressTimer = nullptr;
+    // Smooth progress ratio, advanced by the canvas frame clock during playback
     qreal m_smoothProgressRatio = 0.0;
     // Guard to suppress timer updates while a seek is settling
     bool m_seeking = false;
@@ -1720,87 +2279,70 @@ private:
     
     // Phase 1: Frame processing throttling and instrumentation
     qint64 m_lastFrameProcessMs = 0;
-    qint64 m_lastRepaintMs = 0;
     int m_frameProcessBudgetMs = 16; // ~60fps max processing rate
-    int m_repaintBudgetMs = 16; // ~60fps max repaint rate
     // Debug counters
     mutable int m_framesReceived = 0;
     mutable int m_framesProcessed = 0;
     mutable int m_framesSkipped = 0;
+    // Performance HUD: counters at the previous sample and GUI-side latency since then
+    qint64 m_hudSampleMs = -1;
+    quint64 m_hudPublished = 0;
+    quint64 m_hudConsumed = 0;
+    quint64 m_hudOverwritten = 0;
+    quint64 m_hudLate = 0;
+    qint64 m_hudLatencySumMs = 0;
+    qint64 m_hudLatencyMaxMs = 0;
+    int m_hudLatencyCount = 0;
+    LatencyHistogram m_presentLatenessHistogram;
+    LatencyHistogram m_presentIntervalHistogram;
+    QElapsedTimer m_presentIntervalTimer;
     
-    // Phase 2: Async frame conversion with frame dropping
-    std::atomic<bool> m_conversionBusy{false};
-    QImage m_pendingImage;
-    QImage m_lastImage;
-    QMutex m_frameMutex;
-    std::atomic<quint64> m_frameSerial{0};
-    quint64 m_lastProcessedSerial = 0;
-    mutable int m_framesDropped = 0;
-    mutable int m_conversionsStarted = 0;
-    mutable int m_conversionsCompleted = 0;
+    // Latest-frame mailbox shared with the decoder thread (triple buffer, never blocks)
+    std::shared_ptr<FrameMailbox> m_mailbox;
+    // Canvas-wide animation driver that presents frames and advances progress
+    QPointer<FrameClock> m_frameClock;
+    // Current frame pre-scaled to its device size (see drawFrameScaledToDevice)
+    QImage m_scaledFrame;
+    qint64 m_scaledFrameKey = 0;
+    // Current frame was released by the memory accountant while off-screen
+    bool m_frameEvicted = false;
+    // Last visibility/size pushed to the decoder (see updateDecoderVisibility)
+    bool m_decoderVisible = true;
+    QSize m_decoderTargetSize;
 
 private:
-    // Phase 1: Visibility and frame processing helpers
-    bool isVisibleInAnyView() const {
-        if (!scene() || scene()->views().isEmpty()) return false;
-        auto *view = scene()->views().first();
-        if (!view || !view->viewport()) return false;
-        
-        QRectF viewportRect = view->viewport()->rect();
-        QRectF sceneRect = view->mapToScene(viewportRect.toRect()).boundingRect();
-        QRectF itemSceneRect = mapToScene(boundingRect()).boundingRect();
-        
-        return sceneRect.intersects(itemSceneRect);
-    }
-    
     bool shouldProcessFrame() const {
         const qint64 now = QDateTime::currentMSecsSinceEpoch();
         return (now - m_lastFrameProcessMs) >= m_frameProcessBudgetMs;
     }
     
-    bool shouldRepaint() const {
-        const qint64 now = QDateTime::currentMSecsSinceEpoch();
-        return (now - m_lastRepaintMs) >= m_repaintBudgetMs;
-    }
-    
     void logFrameStats() const {
         // Log stats every 120 frames when multiple videos might be playing
         if (m_framesReceived > 0 && m_framesReceived % 120 == 0) {
             const float processRatio = float(m_framesProcessed) / float(m_framesReceived);
             const float skipRatio = float(m_framesSkipped) / float(m_framesReceived);
-            const float dropRatio = float(m_framesDropped) / float(m_framesReceived);
-            const float conversionEfficiency = (m_conversionsStarted > 0) ? 
-                float(m_conversionsCompleted) / float(m_conversionsStarted) : 0.0f;
+            const quint64 published = m_mailbox ? m_mailbox->publishedCount() : 0;
+            const quint64 overwritten = m_mailbox ? m_mailbox->overwrittenCount() : 0;
+            const float dropRatio = (published > 0) ? float(overwritten) / float(published) : 0.0f;
             
-            qDebug() << "VideoItem frame stats: received=" << m_framesReceived 
+            MOUFFETTE_LOG_DEBUG(logVideo) << "VideoItem frame stats: received=" << m_framesReceived 
                      << "processed=" << m_framesProcessed << "(" << (processRatio * 100.0f) << "%)"
                      << "skipped=" << m_framesSkipped << "(" << (skipRatio * 100.0f) << "%)"
-                     << "dropped=" << m_framesDropped << "(" << (dropRatio * 100.0f) << "%)"
-                     << "conversions=" << m_conversionsStarted << "/" << m_conversionsCompleted 
-                     << "(" << (conversionEfficiency * 100.0f) << "% efficiency)";
+                     << "published=" << published
+                     << "overwritten=" << overwritten << "(" << (dropRatio * 100.0f) << "%)";
         }
     }
     
     void updateProgressBar() {
-        if (!m_progressFillRectItem) return;
         // Use animated ratio instead of direct position calculation
-        const qreal margin = 2.0;
-        const QRectF bgRect = m_progressBgRectItem ? m_progressBgRectItem->rect() : QRectF();
-        const qreal progWpx = bgRect.width();
-        const qreal rowH = bgRect.height();
-    const qreal innerW = std::max<qreal>(0.0, progWpx - 2*margin);
-    // Treat values extremely close to 1.0 as full-width to avoid leaving a tiny gap
-    qreal ratio = std::clamp<qreal>(m_smoothProgressRatio, 0.0, 1.0);
-    if (ratio >= 0.999999) ratio = 1.0;
-    qreal w = innerW * ratio;
-    // Round width to device pixels to avoid sub-pixel truncation artifacts
-    qreal w_rounded = std::round(w);
-    m_progressFillRectItem->setRect(margin, margin, w_rounded, rowH - 2*margin);
+        if (m_controls) m_controls->setProgress(m_smoothProgressRatio);
     }
 
     void maybeAdoptImageSize(const QImage& img) {
         if (img.isNull()) return;
-        QSize newSize = img.size();
+        // Frames may arrive downscaled to the on-screen size: prefer the decoder's native size
+        QSize newSize = m_decoder ? m_decoder->videoSize() : QSize();
+        if (newSize.isEmpty()) newSize = img.size();
         if (newSize.isEmpty()) return;
         // Adopt base size on first meaningful decoded frame (preserves aspect)
         if (!m_adoptedSize) {
@@ -1809,30 +2351,6 @@ private:
     }
 };
 
-QSet<uintptr_t> FrameConversionWorker::s_activeItems;
-
-// Phase 2: FrameConversionWorker implementation (after ResizableVideoItem is fully defined)
-void FrameConversionWorker::run() {
-    if (m_image.isNull()) return;
-
-    // Do the expensive conversion off the main thread
-    QImage converted = m_image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
-    if (converted.isNull()) return;
-
-    // Capture by value for the callback to avoid lifetime issues
-    uintptr_t itemPtr = m_itemPtr;
-    quint64 serial = m_serial;
-
-    // Post result back to main thread via queued connection
-    QMetaObject::invokeMethod(qApp, [itemPtr, converted = std::move(converted), serial]() mutable {
-        // Validate that the item still exists via static registry check
-        if (s_activeItems.contains(itemPtr)) {
-            auto* item = reinterpret_cast<ResizableVideoItem*>(itemPtr);
-            item->onFrameConversionComplete(std::move(converted), serial);
-        }
-    }, Qt::QueuedConnection);
-}
-
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_centralWidget(nullptr)
@@ -2087,6 +2605,8 @@ ScreenCanvas::ScreenCanvas(QWidget* parent)
     , m_panning(false)
 {
     setScene(m_scene);
+    // Mip levels of imported images compete with the decodes on the same bounded pool
+    SharedImageStore::instance()->setWorkerPool(mediaImportPool());
     setDragMode(QGraphicsView::NoDrag);
     setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
@@ -2095,11 +2615,15 @@ ScreenCanvas::ScreenCanvas(QWidget* parent)
     setBackgroundBrush(bgBrush);        // outside the scene rect
     if (m_scene) m_scene->setBackgroundBrush(bgBrush); // inside the scene rect
     setFrameShape(QFrame::NoFrame);
-    setRenderHint(QPainter::Antialiasing);
+    // Full quality when idle; beginInteraction() drops to cheaper hints while zooming/panning
+    setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform | QPainter::TextAntialiasing);
     // Use manual anchoring logic for consistent behavior across platforms
     setTransformationAnchor(QGraphicsView::NoAnchor);
     // When the view is resized, keep the view-centered anchor (we also recenter explicitly on window resize)
     setResizeAnchor(QGraphicsView::AnchorViewCenter);
+    // Screens are static: paint them in drawBackground() and let the view cache the result,
+    // so frame/overlay repaints only recompose the dirty regions on top of it
+    setCacheMode(QGraphicsView::CacheBackground);
     // Enable drag & drop
     setAcceptDrops(true);
     
@@ -2119,25 +2643,281 @@ ScreenCanvas::ScreenCanvas(QWidget* parent)
     grabGesture(Qt::PinchGesture);
 #endif
     // Remote cursor overlay (hidden by default)
-    m_remoteCursorDot = m_scene->addEllipse(0, 0, 10, 10, QPen(QColor(74, 144, 226)), QBrush(Qt::white));
+    // Centered on its origin: the cursor smoother moves it with setPos()
+    m_remoteCursorDot = m_scene->addEllipse(-5, -5, 10, 10, QPen(QColor(74, 144, 226)), QBrush(Qt::white));
     if (m_remoteCursorDot) {
         m_remoteCursorDot->setZValue(10000);
         m_remoteCursorDot->setVisible(false);
     }
+    // One frame clock drives every video item in this canvas
+    m_frameClock = new FrameClock(this);
+    m_cursorSmoother.setItem(m_remoteCursorDot);
+    m_frameClock->registerClient(&m_cursorSmoother);
+    // Visibility feedback to decoders: one pass per burst of pan/zoom events
+    m_mediaVisibilityTimer = new QTimer(this);
+    m_mediaVisibilityTimer->setSingleShot(true);
+    m_mediaVisibilityTimer->setInterval(50);
+    connect(m_mediaVisibilityTimer, &QTimer::timeout, this, &ScreenCanvas::refreshMediaVisibility);
+    // Interaction mode ends once no zoom/pan step arrived for a short while
+    m_interactionIdleTimer = new QTimer(this);
+    m_interactionIdleTimer->setSingleShot(true);
+    m_interactionIdleTimer->setInterval(150);
+    connect(m_interactionIdleTimer, &QTimer::timeout, this, &ScreenCanvas::endInteraction);
+    m_hudTimer = new QTimer(this);
+    m_hudTimer->setInterval(PerformanceHud::RefreshIntervalMs);
+    connect(m_hudTimer, &QTimer::timeout, this, &ScreenCanvas::refreshPerformanceHud);
+    if (qEnvironmentVariableIntValue("MOUFFETTE_HUD") != 0) setPerformanceHudVisible(true);
+    m_statsDumpPath = qEnvironmentVariable("MOUFFETTE_STATS_FILE");
+    if (!m_statsDumpPath.isEmpty()) {
+        const int intervalMs = qEnvironmentVariableIntValue("MOUFFETTE_STATS_INTERVAL_MS");
+        m_statsDumpTimer = new QTimer(this);
+        m_statsDumpTimer->setInterval(intervalMs > 0 ? intervalMs : 10000);
+        connect(m_statsDumpTimer, &QTimer::timeout, this, &ScreenCanvas::writeTimingStatsDump);
+        m_statsDumpTimer->start();
+    }
+}
+
+void ScreenCanvas::beginInteraction() {
+    m_interactionIdleTimer->start();
+    if (m_interacting) return;
+    m_interacting = true;
+    setRenderHint(QPainter::Antialiasing, false);
+    setRenderHint(QPainter::SmoothPixmapTransform, false);
+}
+
+void ScreenCanvas::endInteraction() {
+    if (!m_interacting) return;
+    m_interacting = false;
+    setRenderHint(QPainter::Antialiasing, true);
+    setRenderHint(QPainter::SmoothPixmapTransform, true);
+    // One full-quality repaint (rebuilds scaled caches and requests sharp tiles)
+    resetCachedContent();
+    viewport()->update();
+}
+
+void ScreenCanvas::scheduleOverlayLayout(ResizableMediaBase* item) {
+    if (!item) return;
+    // Laid out at the start of the next paint, so every change made while handling the
+    // current batch of events (zoom steps, moves, selection) costs a single pass
+    m_pendingOverlayLayout.insert(item);
+    viewport()->update();
+}
+
+void ScreenCanvas::cancelOverlayLayout(ResizableMediaBase* item) {
+    m_pendingOverlayLayout.remove(item);
+}
+
+void ScreenCanvas::flushOverlayLayout() {
+    MOUFFETTE_TRACE_SCOPE("canvas", "overlay layout");
+    // Take the batch first: laying out an item may dirty it (or another one) again
+    const QSet<ResizableMediaBase*> batch = std::exchange(m_pendingOverlayLayout, {});
+    for (ResizableMediaBase* item : batch) {
+        item->layoutOverlays();
+    }
+}
+
+void ScreenCanvas::invalidateSelectedOverlays() {
+    // Overlays are only shown for selected items
+    if (!m_scene) return;
+    const QList<QGraphicsItem*> sel = m_scene->selectedItems();
+    for (QGraphicsItem* it : sel) {
+        if (auto* b = dynamic_cast<ResizableMediaBase*>(it)) {
+            b->invalidateOverlayLayout();
+        }
+    }
+}
+
+void ScreenCanvas::scheduleMediaVisibilityUpdate() {
+    if (m_mediaVisibilityTimer && !m_mediaVisibilityTimer->isActive()) {
+        m_mediaVisibilityTimer->start();
+    }
+}
+
+void ScreenCanvas::refreshMediaVisibility() {
+    if (!m_scene) return;
+    const QList<QGraphicsItem*> all = m_scene->items();
+    for (QGraphicsItem* it : all) {
+        if (auto* v = dynamic_cast<ResizableVideoItem*>(it)) {
+            v->updateDecoderVisibility();
+        } else if (auto* p = dynamic_cast<ResizablePixmapItem*>(it)) {
+            p->updateMemoryResidency();
+        } else if (auto* a = dynamic_cast<AnimatedImageItem*>(it)) {
+            a->updateMemoryResidency();
+        }
+    }
+}
+
+void ScreenCanvas::scrollContentsBy(int dx, int dy) {
+    beginInteraction();
+    QGraphicsView::scrollContentsBy(dx, dy);
+    scheduleMediaVisibilityUpdate();
+    if (m_hud.isEnabled()) {
+        // The viewport scroll moved the HUD pixels along with the scene: repaint both spots
+        const QRect hudRect = m_hud.rect(viewport()->rect());
+        viewport()->update(hudRect);
+        viewport()->update(hudRect.translated(dx, dy));
+    }
+}
+
+void ScreenCanvas::paintEvent(QPaintEvent* event) {
+    MOUFFETTE_TRACE_SCOPE("canvas", "paint");
+    // Overlays must be in place before the scene is drawn, not a frame later
+    if (!m_pendingOverlayLayout.isEmpty()) flushOverlayLayout();
+    if (!m_hud.isEnabled()) {
+        QGraphicsView::paintEvent(event);
+        return;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    QGraphicsView::paintEvent(event);
+    m_hud.recordPaint(timer.nsecsElapsed());
+    QPainter painter(viewport());
+    m_hud.paint(&painter, viewport()->rect());
 }
 
-void ScreenCanvas::setScreens(const QList<ScreenInfo>& screens) {
+void ScreenCanvas::setPerformanceHudVisible(bool visible) {
+    if (m_hud.isEnabled() == visible) return;
+    const QRect oldRect = m_hud.rect(viewport()->rect());
+    m_hud.setEnabled(visible);
+    if (visible) {
+        refreshPerformanceHud();
+        m_hudTimer->start();
+    } else {
+        m_hudTimer->stop();
+        viewport()->update(oldRect);
+    }
+}
+
+QJsonObject ScreenCanvas::mediaTimingStats() const {
+    QJsonArray videos;
+    if (m_scene) {
+        for (QGraphicsItem* item : m_scene->items()) {
+            if (auto* video = dynamic_cast<ResizableVideoItem*>(item)) {
+                videos.append(video->timingStatsJson());
+            }
+        }
+    }
+    QJsonObject stats;
+    stats["time"] = QDateTime::currentDateTime().toString(Qt::ISODateWithMs);
+    stats["videos"] = videos;
+    return stats;
+}
+
+void ScreenCanvas::writeTimingStatsDump() {
+    const QJsonObject stats = mediaTimingStats();
+    if (stats["videos"].toArray().isEmpty()) return;
+    QFile file(m_statsDumpPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qWarning() << "Cannot write timing stats to" << m_statsDumpPath << ":" << file.errorString();
+        m_statsDumpTimer->stop();
+        return;
+    }
+    file.write(QJsonDocument(stats).toJson(QJsonDocument::Compact));
+    file.write("\n");
+    // Each line covers one interval: a hitch shows up in its own window, not diluted
+    if (m_scene) {
+        for (QGraphicsItem* item : m_scene->items()) {
+            if (auto* video = dynamic_cast<ResizableVideoItem*>(item)) video->resetTimingStats();
+        }
+    }
+}
+
+void ScreenCanvas::refreshPerformanceHud() {
+    PerformanceHud::Snapshot snapshot;
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    if (m_scene) {
+        for (QGraphicsItem* item : m_scene->items()) {
+            if (auto* video = dynamic_cast<ResizableVideoItem*>(item)) {
+                snapshot.videos.append(video->sampleHudStats(nowMs));
+            }
+        }
+    }
+    snapshot.pendingOverlayLayouts = m_pendingOverlayLayout.size();
+    snapshot.importThreadsActive = mediaImportPool()->activeThreadCount();
+    snapshot.importThreadsMax = mediaImportPool()->maxThreadCount();
+    snapshot.globalThreadsActive = QThreadPool::globalInstance()->activeThreadCount();
+    snapshot.globalThreadsMax = QThreadPool::globalInstance()->maxThreadCount();
+    snapshot.mediaUsageBytes = MediaMemoryAccountant::instance()->usageBytes();
+    snapshot.mediaBudgetBytes = MediaMemoryAccountant::instance()->budgetBytes();
+    if (m_frameClock) {
+        snapshot.refreshRateHz = m_frameClock->refreshRateHz();
+        snapshot.frameClockRunning = m_frameClock->isRunning();
+    }
+    // Old and new extents differ when the number of videos changes
+    const QRect oldRect = m_hud.rect(viewport()->rect());
+    m_hud.refresh(snapshot, nowMs);
+    viewport()->update(oldRect.united(m_hud.rect(viewport()->rect())));
+}
+
+void ScreenCanvas::resizeEvent(QResizeEvent* event) {
+    QGraphicsView::resizeEvent(event);
+    scheduleMediaVisibilityUpdate();
+}
+
+bool ScreenCanvas::setScreens(const QList<ScreenInfo>& screens) {
+    if (!m_screenItems.isEmpty() && screens == m_screens) {
+        // Same displays as before: keep items, media and view untouched
+        return false;
+    }
+    const bool firstLayout = m_screenItems.isEmpty();
+    // Previous top-left of every screen by id, so media can follow their screen
+    QHash<int, QRectF> oldRects;
+    for (int i = 0; i < m_screenItems.size() && i < m_screens.size(); ++i) {
+        if (m_screenItems[i]) oldRects.insert(m_screens[i].id, m_screenItems[i]->rect());
+    }
+
     m_screens = screens;
-    clearScreens();
-    createScreenItems();
-    
-    // Keep a large scene for free movement and center on screens
-    const double LARGE_SCENE_SIZE = 100000.0;
-    QRectF sceneRect(-LARGE_SCENE_SIZE/2, -LARGE_SCENE_SIZE/2, LARGE_SCENE_SIZE, LARGE_SCENE_SIZE);
-    m_scene->setSceneRect(sceneRect);
-    if (!m_screens.isEmpty()) {
-        recenterWithMargin(53);
+    const double H_SPACING = 0.0;  // No horizontal gap between adjacent screens
+    const double V_SPACING = 5.0;  // Keep a small vertical gap between rows
+    const QMap<int, QRectF> positions = calculateCompactPositions(m_scaleFactor, H_SPACING, V_SPACING);
+    // Reuse existing items in place; only create or delete the difference
+    for (int i = 0; i < m_screens.size(); ++i) {
+        if (i < m_screenItems.size()) {
+            updateScreenItem(m_screenItems[i], m_screens[i], i, positions.value(i));
+        } else {
+            QGraphicsRectItem* screenItem = createScreenItem(m_screens[i], i, positions.value(i));
+            screenItem->setZValue(Z_SCREENS);
+            m_screenItems.append(screenItem);
+            m_scene->addItem(screenItem);
+        }
     }
+    while (m_screenItems.size() > m_screens.size()) {
+        QGraphicsRectItem* item = m_screenItems.takeLast();
+        m_scene->removeItem(item);
+        delete item;
+    }
+
+    if (!firstLayout) {
+        // Media keep their place relative to the screen they sit on
+        QHash<int, QPointF> offsets;
+        for (int i = 0; i < m_screens.size(); ++i) {
+            auto it = oldRects.constFind(m_screens[i].id);
+            if (it == oldRects.constEnd()) continue;
+            const QPointF delta = m_screenItems[i]->rect().topLeft() - it.value().topLeft();
+            if (!delta.isNull()) offsets.insert(m_screens[i].id, delta);
+        }
+        if (!offsets.isEmpty()) {
+            const QList<QGraphicsItem*> all = m_scene->items();
+            for (QGraphicsItem* it : all) {
+                auto* media = dynamic_cast<ResizableMediaBase*>(it);
+                if (!media) continue;
+                const QPointF center = media->sceneBoundingRect().center();
+                for (auto o = oldRects.constBegin(); o != oldRects.constEnd(); ++o) {
+                    if (o.value().contains(center)) {
+                        media->setPos(media->pos() + offsets.value(o.key()));
+                        break;
+                    }
+                }
+            }
+        }
+    } else {
+        // Keep a large scene for free movement
+        const double LARGE_SCENE_SIZE = 100000.0;
+        m_scene->setSceneRect(QRectF(-LARGE_SCENE_SIZE/2, -LARGE_SCENE_SIZE/2, LARGE_SCENE_SIZE, LARGE_SCENE_SIZE));
+    }
+    resetCachedContent();
+    scheduleMediaVisibilityUpdate();
+    return true;
 }
 
 void ScreenCanvas::clearScreens() {
@@ -2147,28 +2927,37 @@ void ScreenCanvas::clearScreens() {
         delete item;
     }
     m_screenItems.clear();
+    resetCachedContent();
 }
 
-void ScreenCanvas::createScreenItems() {
-    const double SCALE_FACTOR = m_scaleFactor; // Use member scale factor so drops match
-    const double H_SPACING = 0.0;  // No horizontal gap between adjacent screens
-    const double V_SPACING = 5.0;  // Keep a small vertical gap between rows
-    
-    // Calculate compact positioning
-    QMap<int, QRectF> compactPositions = calculateCompactPositions(SCALE_FACTOR, H_SPACING, V_SPACING);
-    
-    for (int i = 0; i < m_screens.size(); ++i) {
-        const ScreenInfo& screen = m_screens[i];
-        QGraphicsRectItem* screenItem = createScreenItem(screen, i, compactPositions[i]);
-        m_screenItems.append(screenItem);
-        m_scene->addItem(screenItem);
+void ScreenCanvas::drawBackground(QPainter* painter, const QRectF& rect) {
+    QGraphicsView::drawBackground(painter, rect);
+    // Screen items only hold geometry and style (they are hidden); draw them here so they
+    // end up in the cached background instead of being repainted with every frame
+    for (int i = 0; i < m_screenItems.size(); ++i) {
+        QGraphicsRectItem* item = m_screenItems[i];
+        if (!item || !item->sceneBoundingRect().intersects(rect)) continue;
+        painter->save();
+        painter->setTransform(item->sceneTransform(), true);
+        painter->setPen(item->pen());
+        painter->setBrush(item->brush());
+        painter->drawRect(item->rect());
+        if (i < m_screens.size()) {
+            painter->setPen(Qt::white);
+            painter->setFont(QFont("Arial", 12, QFont::Bold));
+            painter->drawText(item->rect(), Qt::AlignCenter, screenLabelText(m_screens[i], i));
+        }
+        painter->restore();
     }
-    ensureZOrder();
 }
 
-void ScreenCanvas::updateRemoteCursor(int globalX, int globalY) {
+QString ScreenCanvas::screenLabelText(const ScreenInfo& screen, int index) {
+    return QString("Screen %1\n%2×%3").arg(index + 1).arg(screen.width).arg(screen.height);
+}
+
+void ScreenCanvas::updateRemoteCursor(int globalX, int globalY, qint64 senderTimeMs) {
     if (!m_remoteCursorDot || m_screens.isEmpty() || m_screenItems.size() != m_screens.size()) {
-        if (m_remoteCursorDot) m_remoteCursorDot->setVisible(false);
+        hideRemoteCursor();
         return;
     }
     int idx = -1;
@@ -2183,24 +2972,27 @@ void ScreenCanvas::updateRemoteCursor(int globalX, int globalY) {
         }
     }
     if (idx < 0) {
-        m_remoteCursorDot->setVisible(false);
+        hideRemoteCursor();
         return;
     }
     QGraphicsRectItem* item = m_screenItems[idx];
-    if (!item) { m_remoteCursorDot->setVisible(false); return; }
+    if (!item) { hideRemoteCursor(); return; }
     const QRectF r = item->rect();
-    if (m_screens[idx].width <= 0 || m_screens[idx].height <= 0 || r.width() <= 0 || r.height() <= 0) { m_remoteCursorDot->setVisible(false); return; }
+    if (m_screens[idx].width <= 0 || m_screens[idx].height <= 0 || r.width() <= 0 || r.height() <= 0) { hideRemoteCursor(); return; }
     const double fx = static_cast<double>(localX) / static_cast<double>(m_screens[idx].width);
     const double fy = static_cast<double>(localY) / static_cast<double>(m_screens[idx].height);
     const double sceneX = r.left() + fx * r.width();
     const double sceneY = r.top() + fy * r.height();
-    const double dotSize = 10.0;
-    m_remoteCursorDot->setRect(sceneX - dotSize/2.0, sceneY - dotSize/2.0, dotSize, dotSize);
+    // The dot itself is moved on the next frame clock ticks (the first sample is shown at once)
+    if (m_cursorSmoother.addSample(QPointF(sceneX, sceneY), senderTimeMs, m_frameClock->nowMs())) {
+        m_frameClock->wake();
+    }
     m_remoteCursorDot->setVisible(true);
 }
 
 void ScreenCanvas::hideRemoteCursor() {
     if (m_remoteCursorDot) m_remoteCursorDot->setVisible(false);
+    m_cursorSmoother.reset();
 }
 
 void ScreenCanvas::ensureZOrder() {
@@ -2292,65 +3084,319 @@ void ScreenCanvas::dragLeaveEvent(QDragLeaveEvent* event) {
     }
 }
 
+QGraphicsItem* ScreenCanvas::importLocalFile(const QString& path, const QPointF& sceneCenter) {
+    if (!m_scene || path.isEmpty()) return nullptr;
+    const QFileInfo info(path);
+    const QString filename = info.fileName();
+    // Decide if it's a video by extension before touching the file contents
+    static const QSet<QString> kVideoExts = {"mp4","mov","m4v","avi","mkv","webm"};
+    static const QSet<QString> kAnimatedExts = {"gif","png","apng","webp"};
+    const QString suffix = info.suffix().toLower();
+    bool loopAsVideo = false;
+    if (kAnimatedExts.contains(suffix)) {
+        // Counting stops past what could be cached, so long GIFs cost a bounded block walk
+        const AnimatedImageStore::Info anim = AnimatedImageStore::probe(path, ANIMATED_IMAGE_CACHE_MAX_BYTES, ANIMATED_IMAGE_MAX_EDGE_PX);
+        if (anim.frameCount > 1 && anim.size.isValid() && !anim.size.isEmpty()) {
+            QSize cached = anim.size;
+            if (std::max(cached.width(), cached.height()) > ANIMATED_IMAGE_MAX_EDGE_PX) {
+                cached = cached.scaled(ANIMATED_IMAGE_MAX_EDGE_PX, ANIMATED_IMAGE_MAX_EDGE_PX, Qt::KeepAspectRatio);
+            }
+            if (static_cast<qint64>(cached.width()) * cached.height() * 4 * anim.frameCount <= ANIMATED_IMAGE_CACHE_MAX_BYTES) {
+                auto* aitem = new AnimatedImageItem(path, anim.size, m_mediaHandleVisualSizePx, m_mediaHandleSelectionSizePx, filename);
+                const double w = anim.size.width() * m_scaleFactor;
+                const double h = anim.size.height() * m_scaleFactor;
+                aitem->setPos(sceneCenter.x() - w/2.0, sceneCenter.y() - h/2.0);
+                aitem->setScale(m_scaleFactor);
+                m_scene->addItem(aitem);
+                aitem->decodeForCurrentView();
+                return aitem;
+            }
+            // Too many frames to keep decoded: stream it like a video, looping (without alpha)
+            loopAsVideo = true;
+        }
+    }
+    if (loopAsVideo || kVideoExts.contains(suffix)) {
+        // Create with placeholder logical size; adopt real size on first frame
+        auto* vitem = new ResizableVideoItem(path, m_mediaHandleVisualSizePx, m_mediaHandleSelectionSizePx, filename);
+        vitem->setInitialScaleFactor(m_scaleFactor);
+        // Start with a neutral 1.0 scale on placeholder size and center approx.
+        vitem->setScale(m_scaleFactor);
+        const double w = 640.0 * m_scaleFactor;
+        const double h = 360.0 * m_scaleFactor;
+        vitem->setPos(sceneCenter.x() - w/2.0, sceneCenter.y() - h/2.0);
+        if (loopAsVideo) vitem->setRepeatEnabled(true);
+        m_scene->addItem(vitem);
+        return vitem;
+    }
+    // Header-only read: the item gets its final size now, pixels are decoded off the GUI thread
+    const QSize headerSize = QImageReader(path).size();
+    if (!headerSize.isValid() || headerSize.isEmpty()) return nullptr;
+    ResizableMediaBase* item = nullptr;
+    ResizablePixmapItem* pixItem = nullptr;
+    if (static_cast<qint64>(headerSize.width()) * headerSize.height() >= TILED_IMAGE_MIN_PIXELS ||
+        std::max(headerSize.width(), headerSize.height()) >= TILED_IMAGE_MIN_EDGE_PX) {
+        // Huge images are never decoded whole: tile them
+        auto source = std::make_unique<TiledImageSource>(path);
+        if (!source->isValid()) return nullptr;
+        item = new TiledImageItem(std::move(source), m_mediaHandleVisualSizePx, m_mediaHandleSelectionSizePx, filename);
+    } else {
+        pixItem = new ResizablePixmapItem(headerSize, m_mediaHandleVisualSizePx, m_mediaHandleSelectionSizePx, filename, path);
+        item = pixItem;
+    }
+    const double w = headerSize.width() * m_scaleFactor;
+    const double h = headerSize.height() * m_scaleFactor;
+    item->setPos(sceneCenter.x() - w/2.0, sceneCenter.y() - h/2.0);
+    item->setScale(m_scaleFactor);
+    m_scene->addItem(item);
+    if (pixItem) pixItem->decodeForCurrentView();
+    return item;
+}
+
+QList<QGraphicsItem*> ScreenCanvas::importLocalFiles(const QStringList& paths, const QPointF& sceneCenter) {
+    QList<QGraphicsItem*> added;
+    // Dropped folders contribute their files (not recursive)
+    QStringList files;
+    for (const QString& path : paths) {
+        const QFileInfo info(path);
+        if (info.isDir()) {
+            const QFileInfoList entries = QDir(path).entryInfoList(QDir::Files | QDir::Readable, QDir::Name);
+            for (const QFileInfo& entry : entries) files.append(entry.absoluteFilePath());
+        } else if (!path.isEmpty()) {
+            files.append(path);
+        }
+    }
+    // Items are created (and their decodes queued) right away; each shows its pixels as
+    // soon as its decode finishes
+    for (const QString& file : files) {
+        if (QGraphicsItem* item = importLocalFile(file, sceneCenter)) added.append(item);
+    }
+    if (added.size() < 2) return added;
+
+    // Arrange in rows of a roughly square grid centered on the drop point
+    const int cols = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(added.size()))));
+    const double gap = DROP_GRID_GAP_PX * m_scaleFactor;
+    QList<QSizeF> sizes;
+    sizes.reserve(added.size());
+    for (QGraphicsItem* item : added) sizes.append(item->sceneBoundingRect().size());
+    QList<double> rowWidths, rowHeights;
+    for (int i = 0; i < added.size(); ++i) {
+        const int row = i / cols;
+        if (row >= rowWidths.size()) { rowWidths.append(-gap); rowHeights.append(0.0); }
+        rowWidths[row] += sizes[i].width() + gap;
+        rowHeights[row] = std::max(rowHeights[row], sizes[i].height());
+    }
+    double totalH = -gap;
+    for (double h : rowHeights) totalH += h + gap;
+    double y = sceneCenter.y() - totalH / 2.0;
+    for (int row = 0; row < rowWidths.size(); ++row) {
+        double x = sceneCenter.x() - rowWidths[row] / 2.0;
+        for (int i = row * cols; i < std::min<int>(added.size(), (row + 1) * cols); ++i) {
+            // Vertically center each item in its row
+            const QRectF br = added[i]->sceneBoundingRect();
+            const QPointF target(x, y + (rowHeights[row] - sizes[i].height()) / 2.0);
+            added[i]->setPos(added[i]->pos() + (target - br.topLeft()));
+            x += sizes[i].width() + gap;
+        }
+        y += rowHeights[row] + gap;
+    }
+    return added;
+}
+
+QVector<CompositionRenderer::Layer> ScreenCanvas::compositionLayers(int screenIndex, const QSize& outputSize) const {
+    QVector<CompositionRenderer::Layer> layers;
+    if (!m_scene || screenIndex < 0 || screenIndex >= m_screenItems.size() || outputSize.isEmpty()) return layers;
+    QGraphicsRectItem* screenItem = m_screenItems[screenIndex];
+    if (!screenItem) return layers;
+    const QRectF target = screenItem->mapRectToScene(screenItem->rect());
+    if (target.isEmpty()) return layers;
+    // Scene -> output pixels of the screen
+    QTransform sceneToOutput;
+    sceneToOutput.scale(outputSize.width() / target.width(), outputSize.height() / target.height());
+    sceneToOutput.translate(-target.left(), -target.top());
+    const QRectF outputRect(QPointF(0, 0), QSizeF(outputSize));
+
+    const QList<QGraphicsItem*> all = m_scene->items(Qt::AscendingOrder);
+    for (QGraphicsItem* it : all) {
+        auto* media = dynamic_cast<ResizableMediaBase*>(it);
+        if (!media || !media->isVisible()) continue;
+        CompositionRenderer::Layer layer;
+        layer.baseSize = media->baseSizePx();
+        layer.transform = media->sceneTransform() * sceneToOutput;
+        if (!layer.transform.mapRect(QRectF(QPointF(0, 0), QSizeF(layer.baseSize))).intersects(outputRect)) continue;
+        if (auto* v = dynamic_cast<ResizableVideoItem*>(media)) {
+            layer.videoPath = v->sourcePath();
+        } else if (auto* a = dynamic_cast<AnimatedImageItem*>(media)) {
+            // The renderer's video decoder has no alpha: transparent animations stay still
+            if (a->hasAlpha()) layer.imagePath = a->sourcePath();
+            else layer.videoPath = a->sourcePath();
+        } else if (auto* t = dynamic_cast<TiledImageItem*>(media)) {
+            layer.imagePath = t->sourcePath();
+        } else if (auto* p = dynamic_cast<ResizablePixmapItem*>(media)) {
+            // Files are read again at the output resolution; pasted pixels are taken as they are
+            layer.imagePath = p->sourcePath();
+            if (layer.imagePath.isEmpty()) layer.image = p->currentImage();
+        }
+        if (layer.videoPath.isEmpty() && layer.imagePath.isEmpty() && layer.image.isNull()) continue;
+        layers.append(layer);
+    }
+    return layers;
+}
+
+bool ScreenCanvas::saveSceneSnapshot(const QString& path, QString* errorString) const {
+    MOUFFETTE_TRACE_SCOPE("canvas", "save snapshot");
+    SceneSnapshot snapshot;
+    if (m_scene) {
+        // Bottom to top: media share one Z value, so insertion order is their stacking order
+        const QList<QGraphicsItem*> all = m_scene->items(Qt::AscendingOrder);
+        for (QGraphicsItem* it : all) {
+            auto* media = dynamic_cast<ResizableMediaBase*>(it);
+            if (!media) continue;
+            SceneSnapshot::Item entry;
+            if (media->captureSnapshot(entry)) snapshot.items.append(std::move(entry));
+        }
+    }
+    return snapshot.write(path, errorString);
+}
+
+bool ScreenCanvas::loadSceneSnapshot(const QString& path, QString* errorString) {
+    if (!m_scene) return false;
+    SceneSnapshot snapshot;
+    if (!snapshot.read(path, errorString)) return false;
+    MOUFFETTE_TRACE_SCOPE("canvas", "restore snapshot");
+    QList<ResizableMediaBase*> previous;
+    for (QGraphicsItem* it : m_scene->items()) {
+        if (auto* media = dynamic_cast<ResizableMediaBase*>(it)) previous.append(media);
+    }
+    for (ResizableMediaBase* media : previous) {
+        // removeItem() also releases the mouse grab
+        m_scene->removeItem(media);
+        delete media;
+    }
+    int missing = 0;
+    for (const SceneSnapshot::Item& entry : snapshot.items) {
+        if (!restoreSnapshotItem(entry)) ++missing;
+    }
+    if (missing > 0) qWarning() << "Canvas layout" << path << ":" << missing << "item(s) could not be restored";
+    // Items shown larger than their preview reload from their files
+    scheduleMediaVisibilityUpdate();
+    return true;
+}
+
+QGraphicsItem* ScreenCanvas::restoreSnapshotItem(const SceneSnapshot::Item& entry) {
+    if (entry.sourcePath.isEmpty()) {
+        // Pasted image: the snapshot holds its pixels
+        if (entry.type != SceneSnapshot::ItemType::Image || entry.preview.isNull()) return nullptr;
+        auto* item = new ResizablePixmapItem(QPixmap::fromImage(entry.preview), m_mediaHandleVisualSizePx, m_mediaHandleSelectionSizePx, entry.label);
+        item->setScale(entry.scale);
+        item->setPos(entry.pos);
+        item->setZValue(entry.zValue);
+        m_scene->addItem(item);
+        return item;
+    }
+    if (!QFileInfo::exists(entry.sourcePath)) return nullptr;
+    // Cached data only applies to the exact file it was taken from
+    const bool fresh = entry.sourceFileUnchanged();
+    ResizableMediaBase* item = nullptr;
+    switch (entry.type) {
+    case SceneSnapshot::ItemType::Image:
+        if (fresh && !entry.preview.isNull() && !entry.contentKey.isEmpty() && !entry.baseSize.isEmpty()) {
+            auto* pixItem = new ResizablePixmapItem(entry.baseSize, m_mediaHandleVisualSizePx, m_mediaHandleSelectionSizePx, entry.label, entry.sourcePath);
+            pixItem->restoreFromSnapshot(entry.contentKey, entry.preview);
+            item = pixItem;
+        }
+        break;
+    case SceneSnapshot::ItemType::TiledImage:
+        if (fresh) {
+            auto source = std::make_unique<TiledImageSource>(entry.sourcePath);
+            if (!source->isValid()) return nullptr;
+            source->insertTile(source->levelCount() - 1, 0, 0, entry.preview);
+            item = new TiledImageItem(std::move(source), m_mediaHandleVisualSizePx, m_mediaHandleSelectionSizePx, entry.label);
+        }
+        break;
+    case SceneSnapshot::ItemType::AnimatedImage:
+        if (fresh && !entry.baseSize.isEmpty()) {
+            auto* aitem = new AnimatedImageItem(entry.sourcePath, entry.baseSize, m_mediaHandleVisualSizePx, m_mediaHandleSelectionSizePx, entry.label);
+            aitem->restoreFromSnapshot(entry.preview);
+            aitem->setScale(entry.scale);
+            aitem->setPos(entry.pos);
+            aitem->setZValue(entry.zValue);
+            m_scene->addItem(aitem);
+            aitem->decodeForCurrentView();
+            return aitem;
+        }
+        break;
+    case SceneSnapshot::ItemType::Video: {
+        const bool cached = fresh && !entry.preview.isNull() && !entry.baseSize.isEmpty();
+        auto* vitem = new ResizableVideoItem(entry.sourcePath, m_mediaHandleVisualSizePx, m_mediaHandleSelectionSizePx, entry.label, !cached);
+        vitem->setInitialScaleFactor(entry.scale);
+        vitem->setScale(entry.scale);
+        if (cached) {
+            vitem->restoreFromSnapshot(entry.baseSize, entry.preview);
+            vitem->setPos(entry.pos);
+        } else {
+            // The real size is adopted on the first frame around the placeholder's center
+            const QSizeF saved = entry.baseSize.isEmpty() ? QSizeF(640, 360) : QSizeF(entry.baseSize);
+            const QPointF center = entry.pos + QPointF(saved.width(), saved.height()) * (entry.scale / 2.0);
+            vitem->setPos(center - QPointF(640.0, 360.0) * (entry.scale / 2.0));
+        }
+        vitem->setZValue(entry.zValue);
+        m_scene->addItem(vitem);
+        return vitem;
+    }
+    }
+    if (item) {
+        item->setScale(entry.scale);
+        item->setPos(entry.pos);
+        m_scene->addItem(item);
+    } else {
+        // File changed since the layout was saved: import it again, keeping the geometry
+        item = dynamic_cast<ResizableMediaBase*>(importLocalFile(entry.sourcePath, QPointF()));
+        if (!item) return nullptr;
+        item->setScale(entry.scale);
+        item->setPos(entry.pos);
+    }
+    item->setZValue(entry.zValue);
+    return item;
+}
+
 void ScreenCanvas::dropEvent(QDropEvent* event) {
-    QImage image;
-    QString filename;
-    QString droppedPath;
+    const QPointF scenePos = mapToScene(event->position().toPoint());
+    QList<QGraphicsItem*> added;
     if (event->mimeData()->hasImage()) {
-        image = qvariant_cast<QImage>(event->mimeData()->imageData());
-        filename = "pasted-image";
+        // Pasted pixels are already decoded
+        const QImage image = qvariant_cast<QImage>(event->mimeData()->imageData());
+        if (!image.isNull() && m_scene) {
+            const double w = image.width() * m_scaleFactor;
+            const double h = image.height() * m_scaleFactor;
+            auto* item = new ResizablePixmapItem(QPixmap::fromImage(image), m_mediaHandleVisualSizePx, m_mediaHandleSelectionSizePx, "pasted-image");
+            item->setFlags(QGraphicsItem::ItemIsMovable | QGraphicsItem::ItemIsSelectable | QGraphicsItem::ItemSendsGeometryChanges);
+            item->setPos(scenePos.x() - w/2.0, scenePos.y() - h/2.0);
+            item->setScale(m_scaleFactor);
+            m_scene->addItem(item);
+            added.append(item);
+        }
     } else if (event->mimeData()->hasUrls()) {
+        QStringList paths;
         const auto urls = event->mimeData()->urls();
-        if (!urls.isEmpty()) {
-            const QUrl& url = urls.first();
-            const QString path = url.toLocalFile();
-            if (!path.isEmpty()) {
-                droppedPath = path;
-                filename = QFileInfo(path).fileName();
-                image.load(path); // may fail if it's a video
-            }
+        for (const QUrl& url : urls) {
+            if (url.isLocalFile()) paths.append(url.toLocalFile());
         }
+        added = importLocalFiles(paths, scenePos);
     }
-    const QPointF scenePos = mapToScene(event->position().toPoint());
-    if (!image.isNull()) {
-        const double w = image.width() * m_scaleFactor;
-        const double h = image.height() * m_scaleFactor;
-        auto* item = new ResizablePixmapItem(QPixmap::fromImage(image), m_mediaHandleVisualSizePx, m_mediaHandleSelectionSizePx, filename);
-        item->setFlags(QGraphicsItem::ItemIsMovable | QGraphicsItem::ItemIsSelectable | QGraphicsItem::ItemSendsGeometryChanges);
-        item->setPos(scenePos.x() - w/2.0, scenePos.y() - h/2.0);
-        if (image.width() > 0) item->setScale(w / image.width());
-    m_scene->addItem(item);
-    // Auto-select the newly dropped item
-    if (m_scene) m_scene->clearSelection();
-    item->setSelected(true);
-    } else if (!droppedPath.isEmpty()) {
-        // Decide if it's a video by extension
-        const QString ext = QFileInfo(droppedPath).suffix().toLower();
-        static const QSet<QString> kVideoExts = {"mp4","mov","m4v","avi","mkv","webm"};
-        if (kVideoExts.contains(ext)) {
-            // Create with placeholder logical size; adopt real size on first frame
-            auto* vitem = new ResizableVideoItem(droppedPath, m_mediaHandleVisualSizePx, m_mediaHandleSelectionSizePx, filename);
-            vitem->setInitialScaleFactor(m_scaleFactor);
-            // Start with a neutral 1.0 scale on placeholder size and center approx.
-            vitem->setScale(m_scaleFactor);
-            const double w = 640.0 * m_scaleFactor;
-            const double h = 360.0 * m_scaleFactor;
-            vitem->setPos(scenePos.x() - w/2.0, scenePos.y() - h/2.0);
-            m_scene->addItem(vitem);
-            // Auto-select the newly dropped video item
-            if (m_scene) m_scene->clearSelection();
-            vitem->setSelected(true);
-            // If a real preview frame exists, set it as poster after adding to the scene
+    if (added.isEmpty()) {
+        QGraphicsView::dropEvent(event);
+        return;
+    }
+    // Auto-select the newly dropped item(s)
+    m_scene->clearSelection();
+    for (QGraphicsItem* item : added) item->setSelected(true);
+    // If a real preview frame exists (single file), use it as the video poster
+    if (added.size() == 1) {
+        if (auto* vitem = dynamic_cast<ResizableVideoItem*>(added.first())) {
             if (!m_dragPreviewPixmap.isNull()) {
                 vitem->setExternalPosterImage(m_dragPreviewPixmap.toImage());
             }
-        } else {
-            QGraphicsView::dropEvent(event);
-            return;
         }
-    } else {
-        QGraphicsView::dropEvent(event);
-        return;
     }
     ensureZOrder();
     event->acceptProposedAction();
@@ -2606,12 +3652,20 @@ void ScreenCanvas::stopDragPreviewFade() {
 }
 
 QGraphicsRectItem* ScreenCanvas::createScreenItem(const ScreenInfo& screen, int index, const QRectF& position) {
+    QGraphicsRectItem* item = new QGraphicsRectItem();
+    // Geometry/style holder only: screens are painted by drawBackground() into the cached background
+    item->setVisible(false);
+    updateScreenItem(item, screen, index, position);
+    return item;
+}
+
+void ScreenCanvas::updateScreenItem(QGraphicsRectItem* item, const ScreenInfo& screen, int index, const QRectF& position) {
     // Border must be fully inside so the outer size matches the logical screen size.
     const int penWidth = m_screenBorderWidthPx; // configurable
     // Inset the rect by half the pen width so the stroke stays entirely inside.
     QRectF inner = position.adjusted(penWidth / 2.0, penWidth / 2.0,
                                      -penWidth / 2.0, -penWidth / 2.0);
-    QGraphicsRectItem* item = new QGraphicsRectItem(inner);
+    item->setRect(inner);
     
     // Set appearance
     if (screen.primary) {
@@ -2624,28 +3678,13 @@ QGraphicsRectItem* ScreenCanvas::createScreenItem(const ScreenInfo& screen, int
     
     // Store screen index for click handling
     item->setData(0, index);
-    
-    // Add screen label
-    QGraphicsTextItem* label = new QGraphicsTextItem(QString("Screen %1\n%2×%3")
-        .arg(index + 1)
-        .arg(screen.width)
-        .arg(screen.height));
-    label->setDefaultTextColor(Qt::white);
-    label->setFont(QFont("Arial", 12, QFont::Bold));
-    
-    // Center the label on the screen
-    QRectF labelRect = label->boundingRect();
-    QRectF screenRect = item->rect();
-    label->setPos(screenRect.center() - labelRect.center());
-    label->setParentItem(item);
-    
-    return item;
+    // The label (screenLabelText) is drawn centered by drawBackground()
 }
 
 void ScreenCanvas::setScreenBorderWidthPx(int px) {
     m_screenBorderWidthPx = qMax(0, px);
     // Update existing screen items to keep the same outer size while drawing the stroke fully inside
-    // We know m_screenItems aligns with m_screens by index after createScreenItems().
+    // We know m_screenItems aligns with m_screens by index after setScreens().
     if (!m_scene) return;
     for (int i = 0; i < m_screenItems.size() && i < m_screens.size(); ++i) {
         QGraphicsRectItem* item = m_screenItems[i];
@@ -2663,6 +3702,7 @@ void ScreenCanvas::setScreenBorderWidthPx(int px) {
         p.setWidthF(penW);
         item->setPen(p);
     }
+    resetCachedContent();
 }
 
 QMap<int, QRectF> ScreenCanvas::calculateCompactPositions(double scaleFactor, double hSpacing, double vSpacing) const {
@@ -2746,6 +3786,7 @@ void ScreenCanvas::recenterWithMargin(int marginPx) {
         // Fallback to a simple fit if viewport is too small
         fitInView(bounds, Qt::KeepAspectRatio);
         centerOn(bounds.center());
+        scheduleMediaVisibilityUpdate();
         return;
     }
 
@@ -2758,18 +3799,9 @@ void ScreenCanvas::recenterWithMargin(int marginPx) {
     t.scale(s, s);
     setTransform(t);
     centerOn(bounds.center());
+    scheduleMediaVisibilityUpdate();
     // After recenter, refresh overlays only for selected items (cheaper and sufficient)
-    if (m_scene) {
-        const QList<QGraphicsItem*> sel = m_scene->selectedItems();
-        for (QGraphicsItem* it : sel) {
-            if (auto* v = dynamic_cast<ResizableVideoItem*>(it)) {
-                v->requestOverlayRelayout();
-            }
-            if (auto* b = dynamic_cast<ResizableMediaBase*>(it)) {
-                b->requestLabelRelayout();
-            }
-        }
-    }
+    invalidateSelectedOverlays();
     // Start momentum suppression: ignore decaying inertial scroll deltas until an increase occurs
     m_ignorePanMomentum = true;
     m_momentumPrimed = false;
@@ -2799,6 +3831,11 @@ void ScreenCanvas::keyPressEvent(QKeyEvent* event) {
         event->accept();
         return;
     }
+    if (event->key() == Qt::Key_F3) {
+        setPerformanceHudVisible(!m_hud.isEnabled());
+        event->accept();
+        return;
+    }
     QGraphicsView::keyPressEvent(event);
 }
 
@@ -3268,6 +4305,7 @@ void ScreenCanvas::zoomAroundViewportPos(const QPointF& vpPosF, qreal factor) {
     if (!viewport()->rect().contains(vpPos)) {
         vpPos = viewport()->rect().center();
     }
+    beginInteraction();
     const QPointF sceneAnchor = mapToScene(vpPos);
     // Compose a new transform that scales around the scene anchor directly
     QTransform t = transform();
@@ -3275,18 +4313,9 @@ void ScreenCanvas::zoomAroundViewportPos(const QPointF& vpPosF, qreal factor) {
     t.scale(factor, factor);
     t.translate(-sceneAnchor.x(), -sceneAnchor.y());
     setTransform(t);
+    scheduleMediaVisibilityUpdate();
     // After zoom, refresh overlays only for selected items
-    if (m_scene) {
-        const QList<QGraphicsItem*> sel = m_scene->selectedItems();
-        for (QGraphicsItem* it : sel) {
-            if (auto* v = dynamic_cast<ResizableVideoItem*>(it)) {
-                v->requestOverlayRelayout();
-            }
-            if (auto* b = dynamic_cast<ResizableMediaBase*>(it)) {
-                b->requestLabelRelayout();
-            }
-        }
-    }
+    invalidateSelectedOverlays();
 }
 
 MainWindow::~MainWindow() {
@@ -3370,9 +4399,9 @@ void MainWindow::setupUI() {
 
     // Receive remote cursor updates when watching
     connect(m_webSocketClient, &WebSocketClient::cursorPositionReceived, this,
-            [this](const QString& targetId, int x, int y) {
+            [this](const QString& targetId, int x, int y, qint64 senderTimeMs) {
                 if (m_stackedWidget->currentWidget() == m_screenViewWidget && targetId == m_watchedClientId && m_screenCanvas) {
-                    m_screenCanvas->updateRemoteCursor(x, y);
+                    m_screenCanvas->updateRemoteCursor(x, y, senderTimeMs);
                 }
             });
 }
@@ -3545,8 +4574,9 @@ void MainWindow::createScreenViewPage() {
         m_screenCanvas->viewport()->setStyleSheet("background-color: transparent; border: none;");
     }
     m_screenCanvas->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-    // Full updates avoid ghosting when moving scene-level overlays with ItemIgnoresTransformations
-    m_screenCanvas->setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+    // Repaint only what changed (frames, progress, cursor dot). Screens come from the cached
+    // background, and overlays keep their geometry in sync via prepareGeometryChange().
+    m_screenCanvas->setViewportUpdateMode(QGraphicsView::SmartViewportUpdate);
     // Screens are not clickable; canvas supports panning and media placement
     canvasLayout->addWidget(m_screenCanvas);
     // Canvas/content opacity effect & animation (apply to the page, not the QGraphicsView viewport to avoid heavy repaints)
@@ -3604,6 +4634,120 @@ void MainWindow::createScreenViewPage() {
 void MainWindow::setupMenuBar() {
     // File menu
     m_fileMenu = menuBar()->addMenu("File");
+
+    // Canvas layouts (SceneSnapshot): prepared in advance and switched live
+    const QString layoutFilter = "Mouffette Canvas Layout (*.mflayout)";
+    QAction* openLayoutAction = new QAction("Open Canvas Layout...", this);
+    openLayoutAction->setShortcut(QKeySequence::Open);
+    connect(openLayoutAction, &QAction::triggered, this, [this, layoutFilter]() {
+        if (!m_screenCanvas) return;
+        const QString path = QFileDialog::getOpenFileName(this, "Open Canvas Layout",
+            QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation), layoutFilter);
+        if (path.isEmpty()) return;
+        QString error;
+        if (!m_screenCanvas->loadSceneSnapshot(path, &error)) {
+            QMessageBox::warning(this, "Open Canvas Layout", error);
+        }
+    });
+    m_fileMenu->addAction(openLayoutAction);
+    QAction* saveLayoutAction = new QAction("Save Canvas Layout...", this);
+    saveLayoutAction->setShortcut(QKeySequence::Save);
+    connect(saveLayoutAction, &QAction::triggered, this, [this, layoutFilter]() {
+        if (!m_screenCanvas) return;
+        const QString suggested = QDir(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation))
+            .filePath(QString("layout-%1.mflayout").arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss")));
+        const QString path = QFileDialog::getSaveFileName(this, "Save Canvas Layout", suggested, layoutFilter);
+        if (path.isEmpty()) return;
+        QString error;
+        if (m_screenCanvas->saveSceneSnapshot(path, &error)) {
+            showTrayMessage("Canvas layout saved", path);
+        } else {
+            QMessageBox::warning(this, "Save Canvas Layout", error);
+        }
+    });
+    m_fileMenu->addAction(saveLayoutAction);
+
+    // Pre-bake what covers one remote screen into a single video (CompositionRenderer)
+    QAction* renderAction = new QAction("Render Composition to Video...", this);
+    connect(renderAction, &QAction::triggered, this, [this]() {
+        if (!m_screenCanvas) return;
+        const QList<ScreenInfo>& screens = m_screenCanvas->screens();
+        if (screens.isEmpty()) {
+            QMessageBox::information(this, "Render Composition", "Connect to a client first: the render is cropped to one of its screens.");
+            return;
+        }
+        int screenIndex = 0;
+        if (screens.size() > 1) {
+            QStringList names;
+            for (int i = 0; i < screens.size(); ++i) {
+                names << QString("Screen %1 (%2×%3)").arg(i + 1).arg(screens[i].width).arg(screens[i].height);
+            }
+            bool ok = false;
+            const QString chosen = QInputDialog::getItem(this, "Render Composition", "Target screen:", names, 0, false, &ok);
+            if (!ok) return;
+            screenIndex = names.indexOf(chosen);
+        }
+        CompositionRenderer::Settings settings;
+        settings.size = QSize(screens[screenIndex].width, screens[screenIndex].height);
+        const QVector<CompositionRenderer::Layer> layers = m_screenCanvas->compositionLayers(screenIndex, settings.size);
+        if (layers.isEmpty()) {
+            QMessageBox::information(this, "Render Composition", "No media covers this screen.");
+            return;
+        }
+        const QString suggested = QDir(QStandardPaths::writableLocation(QStandardPaths::MoviesLocation))
+            .filePath(QString("composition-%1.mp4").arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss")));
+        settings.outputPath = QFileDialog::getSaveFileName(this, "Render Composition", suggested, "MPEG-4 Video (*.mp4)");
+        if (settings.outputPath.isEmpty()) return;
+
+        auto* renderer = new CompositionRenderer(this);
+        auto* progressDialog = new QProgressDialog("Rendering composition...", "Cancel", 0, 0, this);
+        progressDialog->setWindowTitle("Render Composition");
+        progressDialog->setWindowModality(Qt::WindowModal);
+        progressDialog->setMinimumDuration(0);
+        progressDialog->setAttribute(Qt::WA_DeleteOnClose);
+        connect(progressDialog, &QProgressDialog::canceled, renderer, &CompositionRenderer::cancel);
+        connect(renderer, &CompositionRenderer::progress, progressDialog, [progressDialog](int encoded, int total) {
+            progressDialog->setMaximum(total);
+            progressDialog->setValue(encoded);
+        });
+        const QString outputPath = settings.outputPath;
+        // Closing the dialog (X, Esc) cancels and deletes it before the render thread finishes
+        QPointer<QProgressDialog> dialog(progressDialog);
+        connect(renderer, &CompositionRenderer::finished, this, [this, renderer, dialog, outputPath](bool ok, const QString& error) {
+            if (dialog) dialog->close();
+            if (ok) {
+                showTrayMessage("Composition rendered", outputPath);
+            } else if (!error.isEmpty()) {
+                QMessageBox::warning(this, "Render Composition", error);
+            }
+            renderer->deleteLater();
+        });
+        if (!renderer->start(settings, layers)) {
+            progressDialog->close();
+            renderer->deleteLater();
+        }
+    });
+    m_fileMenu->addAction(renderAction);
+    m_fileMenu->addSeparator();
+
+#ifdef MOUFFETTE_TRACING
+    // Dump the trace ring buffers (see Trace.h); load the file in ui.perfetto.dev
+    QAction* exportTraceAction = new QAction("Export Performance Trace...", this);
+    connect(exportTraceAction, &QAction::triggered, this, [this]() {
+        const QString suggested = QDir(QStandardPaths::writableLocation(QStandardPaths::DesktopLocation))
+            .filePath(QString("mouffette-trace-%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss")));
+        const QString path = QFileDialog::getSaveFileName(this, "Export Performance Trace", suggested, "Trace Event JSON (*.json)");
+        if (path.isEmpty()) return;
+        QString error;
+        if (Trace::writeChromeJson(path, &error)) {
+            showTrayMessage("Trace exported", path);
+        } else {
+            QMessageBox::warning(this, "Export Performance Trace", error);
+        }
+    });
+    m_fileMenu->addAction(exportTraceAction);
+    m_fileMenu->addSeparator();
+#endif
     
     m_exitAction = new QAction("Quit Mouffette", this);
     m_exitAction->setShortcut(QKeySequence::Quit);
@@ -3959,13 +5103,18 @@ void MainWindow::onScreensInfoReceived(const ClientInfo& clientInfo) {
         if (m_screenCanvas->scene()) m_screenCanvas->scene()->update();
     }
     if (m_loadingSpinner) { m_loadingSpinner->stop(); }
+        // Only a freshly shown client is recentered and faded in; later screens_info updates
+        // (display changes on the target) are applied in place
+        const bool firstLayout = m_screenCanvas && !m_screenCanvas->hasScreens();
         if (m_screenCanvas) {
             m_screenCanvas->setScreens(clientInfo.getScreens());
-            m_screenCanvas->recenterWithMargin(33);
-            m_screenCanvas->setFocus(Qt::OtherFocusReason);
+            if (firstLayout) {
+                m_screenCanvas->recenterWithMargin(33);
+                m_screenCanvas->setFocus(Qt::OtherFocusReason);
+            }
         }
         // Fade-in canvas content
-    if (m_canvasFade && m_canvasOpacity) {
+    if (firstLayout && m_canvasFade && m_canvasOpacity) {
             applyAnimationDurations();
             m_canvasOpacity->setOpacity(0.0);
             m_canvasFade->setStartValue(0.0);
@@ -29,8 +29,14 @@
 #include <QScrollBar>
 #include <QStackedWidget>
 #include <QElapsedTimer>
+#include <QSet>
+#include <QJsonObject>
 #include "WebSocketClient.h"
 #include "ClientInfo.h"
+#include "PerformanceHud.h"
+#include "RemoteCursorSmoother.h"
+#include "SceneSnapshot.h"
+#include "CompositionRenderer.h"
 
 QT_BEGIN_NAMESPACE
 class QAction;
@@ -45,6 +51,8 @@ class SpinnerWidget; // forward declaration for custom loading spinner
 class QGraphicsOpacityEffect;
 class QPropertyAnimation;
 class QProcess; // fwd decl to avoid including in header
+class FrameClock; // canvas-wide animation driver (FrameClock.h)
+class ResizableMediaBase; // media items (defined in MainWindow.cpp)
 // using QStackedWidget for canvas container switching
 
 // Custom screen canvas widget with zoom and pan capabilities
@@ -53,14 +61,18 @@ class ScreenCanvas : public QGraphicsView {
 
 public:
     explicit ScreenCanvas(QWidget* parent = nullptr);
-    void setScreens(const QList<ScreenInfo>& screens);
+    // Diff against the current layout: changed screens are updated in place and media move
+    // with their screen. Returns false (and touches nothing) when the screens are unchanged.
+    bool setScreens(const QList<ScreenInfo>& screens);
+    bool hasScreens() const { return !m_screenItems.isEmpty(); }
     void clearScreens();
     void recenterWithMargin(int marginPx = 33);
     // Configure fade-in duration (ms) for drag preview appearance
     void setDragPreviewFadeDurationMs(int ms) { m_dragPreviewFadeMs = qMax(0, ms); }
     // (obsolete) video controls fade removed
-    // Remote cursor visualization
-    void updateRemoteCursor(int globalX, int globalY);
+    // Remote cursor visualization. Samples are buffered and interpolated on the frame clock;
+    // senderTimeMs is the watched client's send time (-1 if unknown).
+    void updateRemoteCursor(int globalX, int globalY, qint64 senderTimeMs = -1);
     void hideRemoteCursor();
     // Config: sizes of media resize handles (px, item coordinates)
     void setMediaHandleSelectionSizePx(int px); // hit area for grabbing
@@ -69,6 +81,36 @@ public:
     void setMediaHandleSizePx(int px);
     // Screen border thickness (in pixels). Changing this updates existing screen items.
     void setScreenBorderWidthPx(int px);
+    // Shared animation driver for media items shown in this canvas
+    FrameClock* frameClock() const { return m_frameClock; }
+    // True while zooming/panning: items favour cached or cheaper rendering until the view
+    // settles and is repainted once at full quality
+    bool isInteracting() const { return m_interacting; }
+    // Media overlays (filename label, video controls) are laid out lazily: items mark
+    // themselves dirty and every dirty item is laid out in one batched pass
+    void scheduleOverlayLayout(ResizableMediaBase* item);
+    void cancelOverlayLayout(ResizableMediaBase* item);
+    // Paint rate/time, per-video pipeline, queue and memory overlay (F3 toggles; starts
+    // visible when MOUFFETTE_HUD=1)
+    void setPerformanceHudVisible(bool visible);
+    bool isPerformanceHudVisible() const { return m_hud.isEnabled(); }
+    // Decode/conversion/lateness/interval percentiles of every video item, as
+    // {"time": ..., "videos": [...]}. Also appended as one JSON line per interval to
+    // MOUFFETTE_STATS_FILE (MOUFFETTE_STATS_INTERVAL_MS, default 10 s), each line covering
+    // only that interval.
+    QJsonObject mediaTimingStats() const;
+    // Import several files (folders are expanded), arranged in a grid around sceneCenter.
+    // Used for drops; public so tools (e.g. the canvas benchmark) can populate a canvas.
+    QList<QGraphicsItem*> importLocalFiles(const QStringList& paths, const QPointF& sceneCenter);
+    // Binary canvas layout (SceneSnapshot): media geometry, file references and cached
+    // previews, so a layout restores without decoding or probing anything up front.
+    // Loading replaces every media item of the canvas.
+    bool saveSceneSnapshot(const QString& path, QString* errorString = nullptr) const;
+    bool loadSceneSnapshot(const QString& path, QString* errorString = nullptr);
+    const QList<ScreenInfo>& screens() const { return m_screens; }
+    // Media covering screen `screenIndex`, bottom to top, mapped to outputSize pixels of
+    // that screen (input of CompositionRenderer)
+    QVector<CompositionRenderer::Layer> compositionLayers(int screenIndex, const QSize& outputSize) const;
 
 signals:
 
@@ -86,6 +128,13 @@ protected:
     void dragMoveEvent(QDragMoveEvent* event) override;
     void dragLeaveEvent(QDragLeaveEvent* event) override;
     void dropEvent(QDropEvent* event) override;
+    // View changes (pan/resize) affect which media items are on screen
+    void scrollContentsBy(int dx, int dy) override;
+    void resizeEvent(QResizeEvent* event) override;
+    // Times scene painting for the performance HUD and paints the HUD on top
+    void paintEvent(QPaintEvent* event) override;
+    // Screens are painted here (view caches the background, see CacheBackground)
+    void drawBackground(QPainter* painter, const QRectF& rect) override;
 
 private:
     QGraphicsScene* m_scene;
@@ -107,6 +156,29 @@ private:
     QElapsedTimer m_momentumTimer;        // time since suppression was (re)started
     // Remote cursor overlay
     QGraphicsEllipseItem* m_remoteCursorDot = nullptr;
+    RemoteCursorSmoother m_cursorSmoother;
+    // Ticks at the display refresh rate while any media item is animating
+    FrameClock* m_frameClock = nullptr;
+    // Coalesces visibility/size feedback to video decoders after pan/zoom/resize
+    QTimer* m_mediaVisibilityTimer = nullptr;
+    void scheduleMediaVisibilityUpdate();
+    void refreshMediaVisibility();
+    // Items waiting for overlay relayout; flushed at the start of paintEvent()
+    QSet<ResizableMediaBase*> m_pendingOverlayLayout;
+    void flushOverlayLayout();
+    // Interaction mode: cheaper render hints during gestures, full quality after idle
+    bool m_interacting = false;
+    QTimer* m_interactionIdleTimer = nullptr;
+    void beginInteraction();
+    void endInteraction();
+    // Performance HUD; metrics are only gathered while it is visible
+    PerformanceHud m_hud;
+    QTimer* m_hudTimer = nullptr;
+    void refreshPerformanceHud();
+    QString m_statsDumpPath;
+    QTimer* m_statsDumpTimer = nullptr;
+    void writeTimingStatsDump();
+    void invalidateSelectedOverlays();
     // Unified scale factor used to lay out screens and to scale dropped media (scene pixels per device pixel)
     double m_scaleFactor = 0.2;
     // Resize handle sizes for media items
@@ -142,9 +214,14 @@ private:
     void startDragPreviewFadeIn();
     void stopDragPreviewFade();
     void onFastVideoThumbnailReady(const QImage& img);
+    // Create and add the canvas item for a local media file; nullptr if unsupported
+    QGraphicsItem* importLocalFile(const QString& path, const QPointF& sceneCenter);
+    // Recreate one saved item from its cached data (or re-import it when its file changed)
+    QGraphicsItem* restoreSnapshotItem(const SceneSnapshot::Item& entry);
     
-    void createScreenItems();
+    static QString screenLabelText(const ScreenInfo& screen, int index);
     QGraphicsRectItem* createScreenItem(const ScreenInfo& screen, int index, const QRectF& position);
+    void updateScreenItem(QGraphicsRectItem* item, const ScreenInfo& screen, int index, const QRectF& position);
     QMap<int, QRectF> calculateCompactPositions(double scaleFactor, double hSpacing, double vSpacing) const;
     QRectF screensBoundingRect() const;
     void zoomAroundViewportPos(const QPointF& vpPos, qreal factor);
@@ -0,0 +1,112 @@
+#include "MediaMemoryAccountant.h"
+#include "Log.h"
+#include <QVector>
+#include <algorithm>
+
+namespace {
+constexpr qint64 kDefaultBudgetMb = 1024;
+}
+
+MediaMemoryAccountant* MediaMemoryAccountant::instance()
+{
+    // GUI thread only; outlives every media item (destroyed after main() returns)
+    static MediaMemoryAccountant s_instance;
+    return &s_instance;
+}
+
+MediaMemoryAccountant::MediaMemoryAccountant(QObject* parent)
+    : QObject(parent)
+{
+    qint64 budgetMb = kDefaultBudgetMb;
+    bool ok = false;
+    const qint64 envMb = qEnvironmentVariable("MOUFFETTE_MEDIA_BUDGET_MB").toLongLong(&ok);
+    if (ok && envMb > 0) budgetMb = envMb;
+    m_budgetBytes = budgetMb * 1024 * 1024;
+
+    // Footprint changes arrive per frame; settle them a few times per second
+    m_settleTimer.setSingleShot(true);
+    m_settleTimer.setInterval(250);
+    connect(&m_settleTimer, &QTimer::timeout, this, &MediaMemoryAccountant::settle);
+}
+
+void MediaMemoryAccountant::registerClient(MediaMemoryClient* client)
+{
+    if (!client || m_clientBytes.contains(client)) return;
+    const qint64 bytes = client->mediaMemoryBytes();
+    m_clientBytes.insert(client, bytes);
+    m_usageBytes += bytes;
+    scheduleSettle();
+}
+
+void MediaMemoryAccountant::unregisterClient(MediaMemoryClient* client)
+{
+    auto it = m_clientBytes.find(client);
+    if (it == m_clientBytes.end()) return;
+    m_usageBytes -= it.value();
+    m_clientBytes.erase(it);
+    scheduleSettle();
+}
+
+void MediaMemoryAccountant::notifyChanged(MediaMemoryClient* client)
+{
+    auto it = m_clientBytes.find(client);
+    if (it == m_clientBytes.end()) return;
+    const qint64 bytes = client->mediaMemoryBytes();
+    if (bytes == it.value()) return;
+    m_usageBytes += bytes - it.value();
+    it.value() = bytes;
+    scheduleSettle();
+}
+
+void MediaMemoryAccountant::setBudgetBytes(qint64 bytes)
+{
+    m_budgetBytes = std::max<qint64>(0, bytes);
+    scheduleSettle();
+}
+
+void MediaMemoryAccountant::scheduleSettle()
+{
+    if (!m_settleTimer.isActive()) m_settleTimer.start();
+}
+
+void MediaMemoryAccountant::settle()
+{
+    if (m_usageBytes > m_budgetBytes) {
+        enforceBudget();
+    }
+    if (m_usageBytes != m_lastReportedUsage) {
+        m_lastReportedUsage = m_usageBytes;
+        emit usageChanged(m_usageBytes, m_budgetBytes);
+    }
+}
+
+void MediaMemoryAccountant::enforceBudget()
+{
+    struct Candidate { MediaMemoryClient* client; int tier; qint64 bytes; };
+    QVector<Candidate> candidates;
+    candidates.reserve(m_clientBytes.size());
+    for (auto it = m_clientBytes.cbegin(); it != m_clientBytes.cend(); ++it) {
+        MediaMemoryClient* c = it.key();
+        const bool onScreen = c->isMediaOnScreen();
+        const bool active = c->isMediaActive();
+        // On-screen active items refill their caches immediately; never worth evicting
+        if (onScreen && active) continue;
+        const int tier = (onScreen ? 2 : 0) + (active ? 1 : 0);
+        candidates.append({c, tier, it.value()});
+    }
+    // Off-screen idle, off-screen active, on-screen idle; largest first within a tier
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        if (a.tier != b.tier) return a.tier < b.tier;
+        return a.bytes > b.bytes;
+    });
+
+    const qint64 before = m_usageBytes;
+    for (const Candidate& cand : candidates) {
+        if (m_usageBytes <= m_budgetBytes) break;
+        if (cand.client->releaseMediaMemory() > 0) {
+            notifyChanged(cand.client);
+        }
+    }
+    MOUFFETTE_LOG_DEBUG(logMemory) << "Media memory budget enforced:" << before / (1024 * 1024) << "MB ->"
+                                   << m_usageBytes / (1024 * 1024) << "MB (budget" << m_budgetBytes / (1024 * 1024) << "MB)";
+}
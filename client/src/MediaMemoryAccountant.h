@@ -0,0 +1,61 @@
+#ifndef MEDIAMEMORYACCOUNTANT_H
+#define MEDIAMEMORYACCOUNTANT_H
+
+#include <QObject>
+#include <QHash>
+#include <QTimer>
+
+/**
+ * A media item whose decoded pixels are tracked by the MediaMemoryAccountant.
+ * All calls happen on the GUI thread.
+ */
+class MediaMemoryClient {
+public:
+    virtual ~MediaMemoryClient() = default;
+    // Bytes of decoded image data currently held (frames, posters, pixmaps, scaled caches)
+    virtual qint64 mediaMemoryBytes() const = 0;
+    // Eviction order: off-screen before on-screen, idle before active (e.g. a playing video)
+    virtual bool isMediaOnScreen() const = 0;
+    virtual bool isMediaActive() const = 0;
+    // Drop or downscale caches that can be rebuilt later; returns the bytes freed
+    virtual qint64 releaseMediaMemory() = 0;
+};
+
+/**
+ * Process-wide accounting of media memory with a soft budget.
+ * Clients report footprint changes; when the total exceeds the budget, caches of off-screen
+ * and idle items are released first. Budget defaults to 1 GiB and can be overridden with
+ * the MOUFFETTE_MEDIA_BUDGET_MB environment variable or setBudgetBytes().
+ */
+class MediaMemoryAccountant : public QObject {
+    Q_OBJECT
+
+public:
+    static MediaMemoryAccountant* instance();
+
+    void registerClient(MediaMemoryClient* client);
+    void unregisterClient(MediaMemoryClient* client);
+    // Re-read the client's footprint. Cheap; enforcement and signals are coalesced.
+    void notifyChanged(MediaMemoryClient* client);
+
+    qint64 usageBytes() const { return m_usageBytes; }
+    qint64 budgetBytes() const { return m_budgetBytes; }
+    void setBudgetBytes(qint64 bytes);
+
+signals:
+    void usageChanged(qint64 usageBytes, qint64 budgetBytes);
+
+private:
+    explicit MediaMemoryAccountant(QObject* parent = nullptr);
+    void scheduleSettle();
+    void settle();
+    void enforceBudget();
+
+    QHash<MediaMemoryClient*, qint64> m_clientBytes;
+    qint64 m_usageBytes = 0;
+    qint64 m_budgetBytes = 0;
+    qint64 m_lastReportedUsage = -1;
+    QTimer m_settleTimer;
+};
+
+#endif // MEDIAMEMORYACCOUNTANT_H
@@ -0,0 +1,125 @@
+#include "PerformanceHud.h"
+#include <QFont>
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include <QPainter>
+#include <algorithm>
+
+namespace {
+constexpr int kMarginPx = 10;
+constexpr int kPaddingPx = 8;
+
+const QFont& hudFont()
+{
+    static const QFont font = [] {
+        QFont f = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+        f.setPointSizeF(std::max<qreal>(9.0, f.pointSizeF() - 1.0));
+        return f;
+    }();
+    return font;
+}
+
+QString megabytes(qint64 bytes)
+{
+    return QString::number(static_cast<double>(bytes) / (1024.0 * 1024.0), 'f', 0);
+}
+}
+
+void PerformanceHud::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled) return;
+    m_enabled = enabled;
+    m_sampleCursor = 0;
+    m_sampleFill = 0;
+    m_paintsSinceRefresh = 0;
+    m_lastRefreshMs = -1;
+    m_lines.clear();
+    m_textSize = QSize();
+}
+
+void PerformanceHud::recordPaint(qint64 nsecs)
+{
+    m_paintNs[m_sampleCursor] = nsecs;
+    m_sampleCursor = (m_sampleCursor + 1) % SampleCount;
+    m_sampleFill = std::min(m_sampleFill + 1, SampleCount);
+    ++m_paintsSinceRefresh;
+}
+
+void PerformanceHud::refresh(const Snapshot& snapshot, qint64 nowMs)
+{
+    const double intervalS = (m_lastRefreshMs >= 0 && nowMs > m_lastRefreshMs)
+        ? (nowMs - m_lastRefreshMs) / 1000.0 : 0.0;
+    const double paintFps = intervalS > 0.0 ? m_paintsSinceRefresh / intervalS : 0.0;
+    m_paintsSinceRefresh = 0;
+    m_lastRefreshMs = nowMs;
+
+    // Percentiles over the last SampleCount paints; sorting a copy twice a second is negligible
+    std::array<qint64, SampleCount> sorted = m_paintNs;
+    std::sort(sorted.begin(), sorted.begin() + m_sampleFill);
+    auto percentileMs = [&](double p) {
+        if (m_sampleFill == 0) return 0.0;
+        const int idx = std::clamp(static_cast<int>(p * (m_sampleFill - 1) + 0.5), 0, m_sampleFill - 1);
+        return sorted[idx] / 1.0e6;
+    };
+
+    m_lines.clear();
+    m_lines << QStringLiteral("paint  %1 fps   p50 %2  p95 %3  p99 %4  max %5 ms")
+                   .arg(paintFps, 0, 'f', 1)
+                   .arg(percentileMs(0.50), 0, 'f', 2)
+                   .arg(percentileMs(0.95), 0, 'f', 2)
+                   .arg(percentileMs(0.99), 0, 'f', 2)
+                   .arg(percentileMs(1.0), 0, 'f', 2);
+    m_lines << QStringLiteral("clock  %1 @ %2 Hz")
+                   .arg(snapshot.frameClockRunning ? QStringLiteral("running") : QStringLiteral("idle"))
+                   .arg(snapshot.refreshRateHz, 0, 'f', 0);
+    int pendingFrames = 0;
+    for (const VideoStats& v : snapshot.videos) {
+        if (v.framePending) ++pendingFrames;
+        m_lines << QStringLiteral("video  %1  decode %2  present %3 fps  latency %4/%5 ms  drop %6%")
+                       .arg(v.name.left(24), -24)
+                       .arg(v.decodeFps, 5, 'f', 1)
+                       .arg(v.presentFps, 5, 'f', 1)
+                       .arg(v.meanLatencyMs, 0, 'f', 1)
+                       .arg(v.maxLatencyMs, 0, 'f', 1)
+                       .arg(v.dropRate * 100.0, 0, 'f', 1);
+    }
+    m_lines << QStringLiteral("queues frames %1  overlays %2  import %3/%4  pool %5/%6")
+                   .arg(pendingFrames)
+                   .arg(snapshot.pendingOverlayLayouts)
+                   .arg(snapshot.importThreadsActive).arg(snapshot.importThreadsMax)
+                   .arg(snapshot.globalThreadsActive).arg(snapshot.globalThreadsMax);
+    m_lines << QStringLiteral("memory %1 / %2 MB")
+                   .arg(megabytes(snapshot.mediaUsageBytes), megabytes(snapshot.mediaBudgetBytes));
+
+    const QFontMetrics fm(hudFont());
+    int w = 0;
+    for (const QString& line : m_lines) w = std::max(w, fm.horizontalAdvance(line));
+    m_textSize = QSize(w, fm.lineSpacing() * m_lines.size());
+}
+
+QRect PerformanceHud::rect(const QRect& viewportRect) const
+{
+    if (!m_enabled || m_textSize.isEmpty()) return QRect();
+    const QSize size = m_textSize + QSize(2 * kPaddingPx, 2 * kPaddingPx);
+    return QRect(viewportRect.topLeft() + QPoint(kMarginPx, kMarginPx), size);
+}
+
+void PerformanceHud::paint(QPainter* painter, const QRect& viewportRect) const
+{
+    const QRect box = rect(viewportRect);
+    if (box.isEmpty()) return;
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, true);
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(QColor(0, 0, 0, 170));
+    painter->drawRoundedRect(box, 6, 6);
+    painter->setFont(hudFont());
+    painter->setPen(QColor(220, 255, 220));
+    const QFontMetrics fm(hudFont());
+    int y = box.top() + kPaddingPx + fm.ascent();
+    for (const QString& line : m_lines) {
+        painter->drawText(box.left() + kPaddingPx, y, line);
+        y += fm.lineSpacing();
+    }
+    painter->restore();
+}
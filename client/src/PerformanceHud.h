@@ -0,0 +1,75 @@
+#ifndef PERFORMANCEHUD_H
+#define PERFORMANCEHUD_H
+
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QtGlobal>
+#include <array>
+
+class QPainter;
+
+/**
+ * Text overlay with live rendering and media pipeline metrics, painted by the canvas on
+ * top of the viewport.
+ *
+ * Cheap enough to leave on: recordPaint() is a ring-buffer store, and percentiles and text
+ * are only rebuilt when the canvas pushes a new snapshot (a couple of times per second).
+ * GUI thread only.
+ */
+class PerformanceHud {
+public:
+    // One playing or paused video, measured over the interval since its previous sample
+    struct VideoStats {
+        QString name;
+        double decodeFps = 0.0;      // frames converted and published by the decoder
+        double presentFps = 0.0;     // frames taken by the GUI
+        double meanLatencyMs = 0.0;  // publish -> taken by the GUI
+        double maxLatencyMs = 0.0;
+        double dropRate = 0.0;       // overwritten in the mailbox or decoded too late
+        bool framePending = false;   // a frame waits in the mailbox
+    };
+
+    struct Snapshot {
+        QVector<VideoStats> videos;
+        int pendingOverlayLayouts = 0;
+        int importThreadsActive = 0;
+        int importThreadsMax = 0;
+        int globalThreadsActive = 0;
+        int globalThreadsMax = 0;
+        qint64 mediaUsageBytes = 0;
+        qint64 mediaBudgetBytes = 0;
+        qreal refreshRateHz = 0.0;
+        bool frameClockRunning = false;
+    };
+
+    static constexpr int RefreshIntervalMs = 500;
+
+    bool isEnabled() const { return m_enabled; }
+    void setEnabled(bool enabled);
+
+    // Duration of one canvas paint (nanoseconds)
+    void recordPaint(qint64 nsecs);
+    // Rebuild the text from the paints recorded since the previous refresh and a snapshot
+    void refresh(const Snapshot& snapshot, qint64 nowMs);
+
+    // Area covered by the overlay, in viewport coordinates
+    QRect rect(const QRect& viewportRect) const;
+    void paint(QPainter* painter, const QRect& viewportRect) const;
+
+private:
+    static constexpr int SampleCount = 240;
+
+    bool m_enabled = false;
+    std::array<qint64, SampleCount> m_paintNs{};
+    int m_sampleCursor = 0;
+    int m_sampleFill = 0;
+    int m_paintsSinceRefresh = 0;
+    qint64 m_lastRefreshMs = -1;
+    QStringList m_lines;
+    QSize m_textSize;
+};
+
+#endif // PERFORMANCEHUD_H
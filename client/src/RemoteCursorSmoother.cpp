@@ -0,0 +1,112 @@
+#include "RemoteCursorSmoother.h"
+#include <QGraphicsItem>
+#include <algorithm>
+#include <cmath>
+
+bool RemoteCursorSmoother::addSample(const QPointF& scenePos, qint64 senderTimeMs, qint64 arrivalMs)
+{
+    const double sender = static_cast<double>(senderTimeMs < 0 ? arrivalMs : senderTimeMs);
+    if (!m_samples.isEmpty()) {
+        const double last = m_samples.last().senderMs;
+        // Far behind the newest sample: the sender restarted its clock
+        if (sender < last - 1000.0) reset();
+        else if (sender <= last) return false;
+    }
+
+    const double offset = static_cast<double>(arrivalMs) - sender;
+    m_offsets[m_offsetCursor] = offset;
+    m_offsetCursor = (m_offsetCursor + 1) % OffsetWindow;
+    m_offsetFill = std::min(m_offsetFill + 1, OffsetWindow);
+    m_jitterMs += (offset - baseOffsetMs() - m_jitterMs) / 16.0;
+    m_playoutDelayMs = std::clamp(1.5 * m_jitterMs, 0.0, static_cast<double>(MaxPlayoutDelayMs));
+
+    m_samples.append({scenePos, sender});
+    if (m_samples.size() > MaxSamples) m_samples.removeFirst();
+
+    if (!m_hasDisplayed) {
+        // First sample after a reset: show it as is
+        m_displayed = scenePos;
+        m_hasDisplayed = true;
+        m_correction = QPointF();
+        if (m_item) m_item->setPos(scenePos);
+    } else {
+        // Keep what is on screen and fade towards the new estimate
+        m_correction = m_displayed - targetAt(static_cast<double>(arrivalMs));
+        m_correctionStartMs = static_cast<double>(arrivalMs);
+    }
+    m_settled = false;
+    return true;
+}
+
+void RemoteCursorSmoother::reset()
+{
+    m_samples.clear();
+    m_offsetCursor = 0;
+    m_offsetFill = 0;
+    m_jitterMs = 0.0;
+    m_playoutDelayMs = 0.0;
+    m_correction = QPointF();
+    m_hasDisplayed = false;
+    m_settled = true;
+    m_dirtyRect = QRectF();
+}
+
+bool RemoteCursorSmoother::advanceFrame(qint64 nowMs)
+{
+    if (!m_item || m_samples.isEmpty()) return false;
+    const double now = static_cast<double>(nowMs);
+    bool targetSettled = false;
+    QPointF pos = targetAt(now, &targetSettled);
+    if (!m_correction.isNull()) {
+        const double fade = std::exp(-std::max(0.0, now - m_correctionStartMs) / SettleMs);
+        if (fade < 0.01) m_correction = QPointF();
+        else pos += m_correction * fade;
+    }
+    m_settled = targetSettled && m_correction.isNull();
+    if (pos == m_displayed) return false;
+
+    const QRectF before = m_item->sceneBoundingRect();
+    m_item->setPos(pos);
+    m_displayed = pos;
+    m_dirtyRect = before | m_item->sceneBoundingRect();
+    return true;
+}
+
+QPointF RemoteCursorSmoother::targetAt(double nowMs, bool* settled) const
+{
+    if (settled) *settled = false;
+    // Time on the sender's timeline that is rendered now
+    const double t = nowMs - baseOffsetMs() - m_playoutDelayMs;
+    const Sample& last = m_samples.last();
+    if (t >= last.senderMs) {
+        QPointF velocity;
+        if (m_samples.size() >= 2) {
+            const Sample& prev = m_samples[m_samples.size() - 2];
+            const double gap = last.senderMs - prev.senderMs;
+            if (gap > 0.0 && gap <= MaxSampleGapMs) velocity = (last.pos - prev.pos) / gap;
+        }
+        const double dt = t - last.senderMs;
+        if (velocity.isNull() || dt > MaxExtrapolationMs + 6.0 * SettleMs) {
+            if (settled) *settled = true;
+            return last.pos;
+        }
+        if (dt <= MaxExtrapolationMs) return last.pos + velocity * dt;
+        // No newer sample: the cursor probably stopped, ease back onto the last position
+        return last.pos + velocity * (MaxExtrapolationMs * std::exp(-(dt - MaxExtrapolationMs) / SettleMs));
+    }
+    for (int i = m_samples.size() - 1; i > 0; --i) {
+        const Sample& a = m_samples[i - 1];
+        if (t >= a.senderMs) {
+            const Sample& b = m_samples[i];
+            const double f = (t - a.senderMs) / (b.senderMs - a.senderMs);
+            return a.pos + (b.pos - a.pos) * f;
+        }
+    }
+    return m_samples.first().pos;
+}
+
+double RemoteCursorSmoother::baseOffsetMs() const
+{
+    if (m_offsetFill == 0) return 0.0;
+    return *std::min_element(m_offsets.begin(), m_offsets.begin() + m_offsetFill);
+}
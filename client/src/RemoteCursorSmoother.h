@@ -0,0 +1,77 @@
+#ifndef REMOTECURSORSMOOTHER_H
+#define REMOTECURSORSMOOTHER_H
+
+#include "FrameClock.h"
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+#include <array>
+
+class QGraphicsItem;
+
+/**
+ * Moves the remote cursor dot smoothly between the ~30 Hz cursor samples of the watched
+ * client, on the canvas FrameClock.
+ *
+ * Samples carry the sender's send time. The sender -> receiver offset is the smallest
+ * (arrival - send) seen recently, i.e. the least delayed sample; how much later than that
+ * samples usually arrive is the jitter. The dot is rendered at "now - offset - playout
+ * delay" on the sender's timeline, with the delay following the jitter (capped at
+ * MaxPlayoutDelayMs), interpolating between the samples around that time. Past the newest
+ * sample the last velocity is extrapolated for at most MaxExtrapolationMs, then the dot
+ * eases back onto the last sample (the sender stops sending when the cursor stops). When a
+ * late sample disagrees with what is on screen, the difference fades out instead of jumping.
+ * GUI thread only.
+ */
+class RemoteCursorSmoother : public FrameClockClient {
+public:
+    static constexpr int MaxPlayoutDelayMs = 40;
+    static constexpr int MaxExtrapolationMs = 50;
+
+    // Item moved with setPos(); its shape should be centered on its origin
+    void setItem(QGraphicsItem* item) { m_item = item; }
+
+    // New cursor position (scene coordinates). senderTimeMs < 0 when the sender did not
+    // timestamp it: the arrival time is used instead (no jitter compensation).
+    // Returns true when the clock should be woken.
+    bool addSample(const QPointF& scenePos, qint64 senderTimeMs, qint64 arrivalMs);
+    // Forget all samples (cursor hidden, watched client changed...)
+    void reset();
+
+    qint64 playoutDelayMs() const { return static_cast<qint64>(m_playoutDelayMs); }
+
+    bool advanceFrame(qint64 nowMs) override;
+    QRectF frameDirtySceneRect() const override { return m_dirtyRect; }
+    bool wantsFrames() const override { return m_item && !m_samples.isEmpty() && !m_settled; }
+
+private:
+    struct Sample {
+        QPointF pos;
+        double senderMs = 0.0;
+    };
+    static constexpr int MaxSamples = 8;
+    static constexpr int OffsetWindow = 64;      // ~2 s of samples at 30 Hz
+    static constexpr double MaxSampleGapMs = 100.0; // larger gaps: cursor was idle, no velocity
+    static constexpr double SettleMs = 40.0;     // ease-back / correction time constant
+
+    // Position the dot should have at local time nowMs, from the samples alone
+    QPointF targetAt(double nowMs, bool* settled = nullptr) const;
+    double baseOffsetMs() const;
+
+    QGraphicsItem* m_item = nullptr;
+    QVector<Sample> m_samples;
+    std::array<double, OffsetWindow> m_offsets{};
+    int m_offsetCursor = 0;
+    int m_offsetFill = 0;
+    double m_jitterMs = 0.0;
+    double m_playoutDelayMs = 0.0;
+    // On-screen error left by the latest sample, faded out from m_correctionStartMs
+    QPointF m_correction;
+    double m_correctionStartMs = 0.0;
+    QPointF m_displayed;
+    bool m_hasDisplayed = false;
+    bool m_settled = true;
+    QRectF m_dirtyRect;
+};
+
+#endif // REMOTECURSORSMOOTHER_H
@@ -0,0 +1,124 @@
+#include "SceneSnapshot.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <cstring>
+
+namespace {
+constexpr quint32 kMagic = 0x4D465343; // "MFSC"
+constexpr quint16 kVersion = 1;
+constexpr QDataStream::Version kStreamVersion = QDataStream::Qt_6_0;
+// Sanity bounds against corrupt files (allocation sizes come from the stream)
+constexpr quint32 kMaxItems = 100000;
+constexpr int kMaxPreviewEdgePx = 16384;
+
+// Raw pixels, deflated: much faster to restore than PNG (QDataStream's QImage encoding)
+void writeImage(QDataStream& out, const QImage& image)
+{
+    if (image.isNull()) {
+        out << quint8(0);
+        return;
+    }
+    const QImage img = image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                                     : QImage::Format_RGB32);
+    out << quint8(1) << img.size() << qint32(img.format());
+    out << qCompress(img.constBits(), static_cast<qsizetype>(img.sizeInBytes()), 1);
+}
+
+QImage readImage(QDataStream& in)
+{
+    quint8 present = 0;
+    in >> present;
+    if (!present) return QImage();
+    QSize size;
+    qint32 format = 0;
+    QByteArray packed;
+    in >> size >> format >> packed;
+    if (in.status() != QDataStream::Ok) return QImage();
+    if (size.isEmpty() || size.width() > kMaxPreviewEdgePx || size.height() > kMaxPreviewEdgePx) return QImage();
+    if (format != QImage::Format_ARGB32_Premultiplied && format != QImage::Format_RGB32) return QImage();
+    const QByteArray bits = qUncompress(packed);
+    QImage img(size, static_cast<QImage::Format>(format));
+    if (img.isNull() || bits.size() != img.sizeInBytes()) return QImage();
+    std::memcpy(img.bits(), bits.constData(), static_cast<size_t>(bits.size()));
+    return img;
+}
+} // namespace
+
+void SceneSnapshot::Item::stampSourceFile()
+{
+    const QFileInfo info(sourcePath);
+    fileSize = info.exists() ? info.size() : -1;
+    fileModifiedMs = info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+}
+
+bool SceneSnapshot::Item::sourceFileUnchanged() const
+{
+    const QFileInfo info(sourcePath);
+    return info.exists() && fileSize >= 0 && info.size() == fileSize &&
+           info.lastModified().toMSecsSinceEpoch() == fileModifiedMs;
+}
+
+bool SceneSnapshot::write(const QString& path, QString* errorString) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (errorString) *errorString = file.errorString();
+        return false;
+    }
+    QDataStream out(&file);
+    out << kMagic << kVersion;
+    out.setVersion(kStreamVersion);
+    out << quint32(items.size());
+    for (const Item& item : items) {
+        out << quint8(item.type) << item.sourcePath << item.label << item.fileSize << item.fileModifiedMs
+            << item.contentKey << item.baseSize << item.pos << double(item.scale) << double(item.zValue);
+        writeImage(out, item.preview);
+    }
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        if (errorString) *errorString = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool SceneSnapshot::read(const QString& path, QString* errorString)
+{
+    auto fail = [errorString](const QString& message) {
+        if (errorString) *errorString = message;
+        return false;
+    };
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return fail(file.errorString());
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != kMagic) return fail(QString("%1 is not a Mouffette canvas file").arg(path));
+    if (version > kVersion) return fail(QString("%1 was saved by a newer version of Mouffette").arg(path));
+    in.setVersion(kStreamVersion);
+
+    quint32 count = 0;
+    in >> count;
+    if (count > kMaxItems) return fail(QString("%1 is corrupted").arg(path));
+    QVector<Item> loaded;
+    loaded.reserve(static_cast<int>(count));
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        Item item;
+        quint8 type = 0;
+        double scale = 1.0, z = 0.0;
+        in >> type >> item.sourcePath >> item.label >> item.fileSize >> item.fileModifiedMs
+           >> item.contentKey >> item.baseSize >> item.pos >> scale >> z;
+        item.type = static_cast<ItemType>(type);
+        item.scale = scale;
+        item.zValue = z;
+        item.preview = readImage(in);
+        // Unknown item types (newer minor additions) are skipped
+        if (type >= quint8(ItemType::Image) && type <= quint8(ItemType::AnimatedImage)) loaded.append(std::move(item));
+    }
+    if (in.status() != QDataStream::Ok) return fail(QString("%1 is truncated or corrupted").arg(path));
+    items = std::move(loaded);
+    return true;
+}
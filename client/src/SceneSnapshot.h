@@ -0,0 +1,60 @@
+#ifndef SCENESNAPSHOT_H
+#define SCENESNAPSHOT_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QPointF>
+#include <QSize>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * Binary save file of a canvas layout (QDataStream, versioned).
+ *
+ * Each media item is stored with its geometry, the file it shows and enough cached pixels
+ * (a preview from the image's mip levels, the coarsest tile of a tiled image, the current
+ * video frame) to be displayed right away on restore. Full-resolution pixels are decoded
+ * lazily afterwards, like any other item. Files are referenced by absolute path, with their
+ * size and modification time so stale cached data is ignored when a file changed.
+ * Previews are stored as zlib-compressed raw pixels: restoring one is a memcpy-speed
+ * inflate instead of an image decode.
+ */
+struct SceneSnapshot {
+    enum class ItemType : quint8 {
+        Image = 1,      // ResizablePixmapItem (no source path: pasted pixels, preview is the full image)
+        TiledImage = 2, // TiledImageItem; preview is the coarsest tile
+        Video = 3,      // ResizableVideoItem; preview is the poster / last shown frame
+        AnimatedImage = 4, // AnimatedImageItem; preview is the first frame
+    };
+
+    struct Item {
+        ItemType type = ItemType::Image;
+        QString sourcePath;
+        QString label;
+        qint64 fileSize = -1;
+        qint64 fileModifiedMs = -1;
+        // SharedImageStore content key (images only)
+        QByteArray contentKey;
+        QSize baseSize;
+        QPointF pos;
+        qreal scale = 1.0;
+        qreal zValue = 0.0;
+        QImage preview;
+
+        // Record the current size/modification time of sourcePath
+        void stampSourceFile();
+        // sourcePath still has the size/modification time recorded when saving
+        bool sourceFileUnchanged() const;
+    };
+
+    // Longest edge of image previews; zooming in further reloads from the file
+    static constexpr int PreviewEdgePx = 512;
+
+    QVector<Item> items;
+
+    bool write(const QString& path, QString* errorString = nullptr) const;
+    bool read(const QString& path, QString* errorString = nullptr);
+};
+
+#endif // SCENESNAPSHOT_H
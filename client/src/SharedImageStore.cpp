@@ -0,0 +1,179 @@
+#include "SharedImageStore.h"
+#include "MediaMemoryAccountant.h"
+#include <QApplication>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QImage>
+#include <QThreadPool>
+#include <algorithm>
+
+namespace {
+// Smallest longest side (px) of a mip level
+constexpr int kMipMinEdgePx = 64;
+
+qint64 pixmapBytes(const QPixmap& pm)
+{
+    return static_cast<qint64>(pm.width()) * pm.height() * pm.depth() / 8;
+}
+}
+
+qint64 SharedImage::bytes() const
+{
+    qint64 total = pixmapBytes(m_pixmap);
+    for (const QPixmap& level : m_mips) total += pixmapBytes(level);
+    return total;
+}
+
+const QPixmap& SharedImage::levelForDeviceWidth(qreal deviceWidth) const
+{
+    const QPixmap* best = &m_pixmap;
+    for (const QPixmap& level : m_mips) {
+        if (level.width() < deviceWidth) break;
+        best = &level;
+    }
+    return *best;
+}
+
+SharedImageStore* SharedImageStore::instance()
+{
+    // GUI thread only; outlives every media item (destroyed after main() returns)
+    static SharedImageStore s_instance;
+    return &s_instance;
+}
+
+QByteArray SharedImageStore::hashFile(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&file)) return QByteArray();
+    return "file:" + hash.result().toHex();
+}
+
+QByteArray SharedImageStore::hashImage(const QImage& image)
+{
+    if (image.isNull()) return QByteArray();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    const qint32 header[3] = { image.width(), image.height(), static_cast<qint32>(image.format()) };
+    hash.addData(QByteArrayView(reinterpret_cast<const char*>(header), sizeof(header)));
+    // Row by row: padding at the end of scanlines is not part of the content
+    const qsizetype rowBytes = (static_cast<qsizetype>(image.width()) * image.depth() + 7) / 8;
+    for (int y = 0; y < image.height(); ++y) {
+        hash.addData(QByteArrayView(reinterpret_cast<const char*>(image.constScanLine(y)), rowBytes));
+    }
+    return "pixels:" + hash.result().toHex();
+}
+
+std::shared_ptr<SharedImage> SharedImageStore::find(const QByteArray& key, const QSize& minSize) const
+{
+    if (key.isEmpty()) return nullptr;
+    std::shared_ptr<SharedImage> image = m_images.value(key).lock();
+    if (!image) return nullptr;
+    if (!image->isReduced()) return image;
+    const QSize have = image->pixmap().size();
+    if (minSize.isValid() && have.width() >= minSize.width() && have.height() >= minSize.height()) return image;
+    return nullptr;
+}
+
+std::shared_ptr<SharedImage> SharedImageStore::insert(const QByteArray& key, const QImage& image, bool reduced)
+{
+    if (key.isEmpty()) return createUnshared(QPixmap::fromImage(image), reduced, image);
+    if (std::shared_ptr<SharedImage> existing = m_images.value(key).lock()) {
+        const QSize have = existing->pixmap().size();
+        if (!existing->isReduced() || (have.width() >= image.width() && have.height() >= image.height())) {
+            return existing;
+        }
+    }
+    // New or sharper: later lookups get this one; holders of the old copy keep theirs
+    std::shared_ptr<SharedImage> shared = create(key, QPixmap::fromImage(image), reduced, image);
+    m_images.insert(key, shared);
+    return shared;
+}
+
+std::shared_ptr<SharedImage> SharedImageStore::createUnshared(const QPixmap& pixmap, bool reduced, const QImage& source)
+{
+    return create(QByteArray(), pixmap, reduced, source);
+}
+
+std::shared_ptr<SharedImage> SharedImageStore::adopt(const QByteArray& key, const std::shared_ptr<SharedImage>& image)
+{
+    if (key.isEmpty() || !image || !image->m_key.isEmpty()) return image;
+    if (std::shared_ptr<SharedImage> existing = m_images.value(key).lock()) {
+        const QSize have = existing->pixmap().size();
+        const QSize size = image->pixmap().size();
+        if (!existing->isReduced() || (have.width() >= size.width() && have.height() >= size.height())) {
+            return existing;
+        }
+    }
+    image->m_key = key;
+    m_images.insert(key, image);
+    return image;
+}
+
+void SharedImageStore::assign(std::shared_ptr<SharedImage>& slot, std::shared_ptr<SharedImage> image, MediaMemoryClient* holder)
+{
+    if (slot == image) return;
+    std::shared_ptr<SharedImage> previous = std::move(slot);
+    if (previous) previous->m_holders.removeOne(holder);
+    slot = std::move(image);
+    if (slot) slot->m_holders.append(holder);
+    MediaMemoryAccountant* accountant = MediaMemoryAccountant::instance();
+    accountant->notifyChanged(holder);
+    if (previous) {
+        for (MediaMemoryClient* other : std::as_const(previous->m_holders)) accountant->notifyChanged(other);
+    }
+    if (slot) {
+        for (MediaMemoryClient* other : std::as_const(slot->m_holders)) {
+            if (other != holder) accountant->notifyChanged(other);
+        }
+    }
+    // `previous` is freed here when we were its last holder
+}
+
+std::shared_ptr<SharedImage> SharedImageStore::create(const QByteArray& key, const QPixmap& pixmap, bool reduced, const QImage& source)
+{
+    // The last holder releasing the image also drops it from the store
+    std::shared_ptr<SharedImage> image(new SharedImage, [](SharedImage* p) {
+        SharedImageStore::instance()->forget(p);
+        delete p;
+    });
+    image->m_key = key;
+    image->m_pixmap = pixmap;
+    image->m_reduced = reduced;
+    buildMipsAsync(image, source);
+    return image;
+}
+
+void SharedImageStore::forget(const SharedImage* image)
+{
+    if (image->m_key.isEmpty()) return;
+    auto it = m_images.find(image->m_key);
+    // The key may already point at a newer copy of the same content
+    if (it != m_images.end() && it.value().expired()) m_images.erase(it);
+}
+
+void SharedImageStore::buildMipsAsync(const std::shared_ptr<SharedImage>& image, QImage source)
+{
+    const QPixmap& pm = image->pixmap();
+    if (pm.isNull() || std::max(pm.width(), pm.height()) < 2 * kMipMinEdgePx) return;
+    // Callers usually still have the decoded image; converting back copies every pixel
+    if (source.isNull()) source = pm.toImage();
+    std::weak_ptr<SharedImage> weak = image;
+    QThreadPool* pool = m_workerPool ? m_workerPool : QThreadPool::globalInstance();
+    pool->start([weak, source = std::move(source)]() {
+        QVector<QImage> levels;
+        QImage current = source;
+        while (std::max(current.width(), current.height()) >= 2 * kMipMinEdgePx) {
+            current = current.scaled(std::max(1, current.width() / 2), std::max(1, current.height() / 2),
+                                     Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+            levels.append(current);
+        }
+        QMetaObject::invokeMethod(qApp, [weak, levels = std::move(levels)]() {
+            std::shared_ptr<SharedImage> image = weak.lock();
+            if (!image) return;
+            image->m_mips.reserve(levels.size());
+            for (const QImage& level : levels) image->m_mips.append(QPixmap::fromImage(level));
+            emit SharedImageStore::instance()->mipsReady(image.get());
+        }, Qt::QueuedConnection);
+    });
+}
@@ -0,0 +1,90 @@
+#ifndef SHAREDIMAGESTORE_H
+#define SHAREDIMAGESTORE_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QPixmap>
+#include <QVector>
+#include <memory>
+
+class MediaMemoryClient;
+class QThreadPool;
+
+/**
+ * Decoded pixels (and their mip levels) of one image, shared by every item showing the
+ * same content. Immutable once handed out, except for the mip levels which arrive later.
+ */
+class SharedImage {
+public:
+    QByteArray key() const { return m_key; }
+    const QPixmap& pixmap() const { return m_pixmap; }
+    // Half-size levels of pixmap() (level i is 1/2^(i+1)), empty until built in the background
+    const QVector<QPixmap>& mips() const { return m_mips; }
+    // Decoded below the source file's full resolution
+    bool isReduced() const { return m_reduced; }
+    qint64 bytes() const;
+    // Items showing this image (see SharedImageStore::assign); bytes() is split between them
+    int holderCount() const { return m_holders.size(); }
+    // Smallest level still at least deviceWidth pixels wide (pixmap() when zoomed in)
+    const QPixmap& levelForDeviceWidth(qreal deviceWidth) const;
+
+private:
+    friend class SharedImageStore;
+    QByteArray m_key;
+    QPixmap m_pixmap;
+    QVector<QPixmap> m_mips;
+    bool m_reduced = false;
+    QVector<MediaMemoryClient*> m_holders;
+};
+
+/**
+ * Process-wide store of decoded images keyed by a hash of their content, so dropping the
+ * same file (or pasting the same pixels) several times keeps a single copy in memory.
+ * The store only holds weak references: an image is freed as soon as the last item using
+ * it lets go. GUI thread only, except the static hash helpers.
+ */
+class SharedImageStore : public QObject {
+    Q_OBJECT
+
+public:
+    static SharedImageStore* instance();
+
+    // Content keys; safe to call from worker threads. Empty on read failure.
+    static QByteArray hashFile(const QString& path);
+    static QByteArray hashImage(const QImage& image);
+
+    // Image with this content covering minSize (or at full resolution), if any item holds one
+    std::shared_ptr<SharedImage> find(const QByteArray& key, const QSize& minSize) const;
+    // Share freshly decoded pixels. When an image with the same content at an equal or
+    // better resolution already exists, that one is returned and `image` is dropped.
+    std::shared_ptr<SharedImage> insert(const QByteArray& key, const QImage& image, bool reduced);
+    // Private image (e.g. a copy reduced for the memory budget); gets mip levels but is not shared.
+    // Pass the same pixels as `source` when at hand, so the levels need no copy back from the pixmap.
+    std::shared_ptr<SharedImage> createUnshared(const QPixmap& pixmap, bool reduced, const QImage& source = QImage());
+    // Share a private image under `key` once its content hash is known. Like insert(), an
+    // existing image with the same content at an equal or better resolution is returned instead.
+    std::shared_ptr<SharedImage> adopt(const QByteArray& key, const std::shared_ptr<SharedImage>& image);
+    // Make `holder` show `image` (or nothing) instead of what `slot` holds. Every holder of
+    // either image is re-accounted with the MediaMemoryAccountant, since its share changed.
+    void assign(std::shared_ptr<SharedImage>& slot, std::shared_ptr<SharedImage> image, MediaMemoryClient* holder);
+
+    int uniqueImageCount() const { return m_images.size(); }
+    // Pool building mip levels (the global pool until set)
+    void setWorkerPool(QThreadPool* pool) { m_workerPool = pool; }
+
+signals:
+    // Mip levels of `image` became available (repaint / re-account its users)
+    void mipsReady(const SharedImage* image);
+
+private:
+    SharedImageStore() = default;
+    std::shared_ptr<SharedImage> create(const QByteArray& key, const QPixmap& pixmap, bool reduced, const QImage& source);
+    void buildMipsAsync(const std::shared_ptr<SharedImage>& image, QImage source);
+    void forget(const SharedImage* image);
+
+    QHash<QByteArray, std::weak_ptr<SharedImage>> m_images;
+    QThreadPool* m_workerPool = nullptr;
+};
+
+#endif // SHAREDIMAGESTORE_H
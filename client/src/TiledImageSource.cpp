@@ -0,0 +1,280 @@
+#include "TiledImageSource.h"
+#include "Trace.h"
+#include <QApplication>
+#include <QHash>
+#include <QImageReader>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPointer>
+#include <QThread>
+#include <QThreadPool>
+#include <QDebug>
+#include <algorithm>
+#include <climits>
+#include <atomic>
+#include <cmath>
+
+namespace {
+// Default cap of decoded tiles per image
+constexpr qint64 kDefaultCacheLimitBytes = 128LL * 1024 * 1024;
+// A queued tile not requested again within this many paint passes is skipped
+constexpr quint64 kStaleFrames = 2;
+
+QThreadPool* tileDecodePool()
+{
+    // Separate from the global pool so a burst of tiles never starves other background work
+    static QThreadPool* s_pool = [] {
+        auto* pool = new QThreadPool(qApp);
+        pool->setMaxThreadCount(std::clamp(QThread::idealThreadCount() / 2, 1, 4));
+        return pool;
+    }();
+    return s_pool;
+}
+}
+
+struct TiledImageSource::SharedState {
+    QMutex mutex;
+    QHash<quint64, quint64> wantedAtFrame;
+    std::atomic<quint64> frame{0};
+};
+
+TiledImageSource::TiledImageSource(const QString& path, QObject* parent)
+    : QObject(parent)
+    , m_path(path)
+    , m_shared(std::make_shared<SharedState>())
+{
+    QImageReader reader(path);
+    // Clip rects address stored pixels; EXIF orientation is not applied to tiles
+    reader.setAutoTransform(false);
+    m_fullSize = reader.size();
+    if (m_fullSize.isEmpty()) {
+        qWarning() << "TiledImageSource: cannot read image header of" << path << reader.errorString();
+        return;
+    }
+    m_regionReads = reader.supportsOption(QImageIOHandler::ClipRect) &&
+                    reader.supportsOption(QImageIOHandler::ScaledSize);
+    if (!m_regionReads) {
+        // The pyramid path decodes the whole image at once: lift Qt's allocation limit
+        // (256 MB by default) enough for it
+        const qint64 neededMb = static_cast<qint64>(m_fullSize.width()) * m_fullSize.height() * 4 / (1024 * 1024) + 1;
+        if (QImageReader::allocationLimit() > 0 && neededMb > QImageReader::allocationLimit()) {
+            QImageReader::setAllocationLimit(static_cast<int>(std::min<qint64>(neededMb, INT_MAX)));
+        }
+    }
+    m_levelCount = 1;
+    while (true) {
+        const QSize s = levelSize(m_levelCount - 1);
+        if (s.width() <= TileSizePx && s.height() <= TileSizePx) break;
+        ++m_levelCount;
+    }
+    m_cache.setMaxCost(kDefaultCacheLimitBytes);
+}
+
+TiledImageSource::~TiledImageSource() = default;
+
+QSize TiledImageSource::levelSize(int level) const
+{
+    const int div = 1 << std::clamp(level, 0, 30);
+    return QSize(std::max(1, (m_fullSize.width() + div - 1) / div),
+                 std::max(1, (m_fullSize.height() + div - 1) / div));
+}
+
+QSize TiledImageSource::tileGrid(int level) const
+{
+    const QSize s = levelSize(level);
+    return QSize((s.width() + TileSizePx - 1) / TileSizePx, (s.height() + TileSizePx - 1) / TileSizePx);
+}
+
+QRect TiledImageSource::tileRect(int level, int col, int row) const
+{
+    return QRect(col * TileSizePx, row * TileSizePx, TileSizePx, TileSizePx)
+        .intersected(QRect(QPoint(0, 0), levelSize(level)));
+}
+
+int TiledImageSource::levelForScale(qreal scale) const
+{
+    if (m_levelCount <= 0 || scale >= 1.0) return 0;
+    if (scale <= 0.0) return m_levelCount - 1;
+    const int level = static_cast<int>(std::floor(std::log2(1.0 / scale)));
+    return std::clamp(level, 0, m_levelCount - 1);
+}
+
+quint64 TiledImageSource::tileKey(int level, int col, int row)
+{
+    return (static_cast<quint64>(level) << 56) | (static_cast<quint64>(col & 0x0FFFFFFF) << 28)
+         | static_cast<quint64>(row & 0x0FFFFFFF);
+}
+
+void TiledImageSource::beginFrame()
+{
+    m_shared->frame.fetch_add(1, std::memory_order_relaxed);
+}
+
+QImage TiledImageSource::cachedTile(int level, int col, int row) const
+{
+    const quint64 key = tileKey(level, col, row);
+    if (const QImage* img = m_cache.object(key)) return *img;
+    return m_pyramidTiles.value(key);
+}
+
+void TiledImageSource::insertTile(int level, int col, int row, const QImage& image)
+{
+    if (image.isNull() || level < 0 || level >= m_levelCount) return;
+    if (image.size() != tileRect(level, col, row).size()) return;
+    const quint64 key = tileKey(level, col, row);
+    m_cache.insert(key, new QImage(image), static_cast<qsizetype>(image.sizeInBytes()));
+}
+
+QImage TiledImageSource::tile(int level, int col, int row)
+{
+    if (!isValid() || level < 0 || level >= m_levelCount) return QImage();
+    const quint64 key = tileKey(level, col, row);
+    if (const QImage* img = m_cache.object(key)) return *img;
+    if (m_failed.contains(key)) return QImage();
+    if (!m_regionReads) {
+        if (m_pyramidState == PyramidState::Ready) return m_pyramidTiles.value(key);
+        decodePyramidAsync();
+        return QImage();
+    }
+
+    const quint64 frame = m_shared->frame.load(std::memory_order_relaxed);
+    {
+        QMutexLocker lock(&m_shared->mutex);
+        m_shared->wantedAtFrame.insert(key, frame);
+    }
+    if (m_pending.contains(key)) return QImage();
+    m_pending.insert(key);
+
+    // Source pixels covered by this tile (clipped to the image)
+    const QRect levelRect = tileRect(level, col, row);
+    const int f = 1 << level;
+    const QRect srcRect = QRect(levelRect.x() * f, levelRect.y() * f, levelRect.width() * f, levelRect.height() * f)
+                              .intersected(QRect(QPoint(0, 0), m_fullSize));
+    const QSize outSize = levelRect.size();
+    std::shared_ptr<SharedState> shared = m_shared;
+    QPointer<TiledImageSource> self(this);
+    const QString path = m_path;
+    tileDecodePool()->start([self, shared, path, key, level, col, row, srcRect, outSize]() {
+        {
+            QMutexLocker lock(&shared->mutex);
+            const quint64 now = shared->frame.load(std::memory_order_relaxed);
+            const quint64 wanted = shared->wantedAtFrame.value(key, 0);
+            if (now - wanted > kStaleFrames) {
+                // Scrolled or zoomed away before we got to it
+                shared->wantedAtFrame.remove(key);
+                lock.unlock();
+                QMetaObject::invokeMethod(qApp, [self, key, level, col, row]() {
+                    if (self) self->onTileDecoded(key, level, col, row, QImage(), false);
+                }, Qt::QueuedConnection);
+                return;
+            }
+        }
+        MOUFFETTE_TRACE_SCOPE("image", "decode tile");
+        QImageReader reader(path);
+        reader.setAutoTransform(false);
+        reader.setClipRect(srcRect);
+        reader.setScaledSize(outSize);
+        QImage img = reader.read();
+        if (img.isNull()) {
+            qWarning() << "TiledImageSource: cannot decode tile of" << path << reader.errorString();
+        } else {
+            img.convertTo(img.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32);
+        }
+        const bool failed = img.isNull();
+        QMetaObject::invokeMethod(qApp, [self, key, level, col, row, img = std::move(img), failed]() {
+            if (self) self->onTileDecoded(key, level, col, row, img, failed);
+        }, Qt::QueuedConnection);
+    });
+    return QImage();
+}
+
+void TiledImageSource::onTileDecoded(quint64 key, int level, int col, int row, const QImage& image, bool failed)
+{
+    m_pending.remove(key);
+    {
+        QMutexLocker lock(&m_shared->mutex);
+        m_shared->wantedAtFrame.remove(key);
+    }
+    // Painting requests tiles again on every pass: never queue a broken one again
+    if (failed) m_failed.insert(key);
+    if (image.isNull()) return;
+    m_cache.insert(key, new QImage(image), static_cast<qsizetype>(image.sizeInBytes()));
+    emit tileReady(level, col, row);
+}
+
+void TiledImageSource::decodePyramidAsync()
+{
+    if (m_pyramidState == PyramidState::Decoding || m_pyramidState == PyramidState::Failed) return;
+    m_pyramidState = PyramidState::Decoding;
+    QPointer<TiledImageSource> self(this);
+    const QString path = m_path;
+    const int levelCount = m_levelCount;
+    tileDecodePool()->start([self, path, levelCount]() {
+        MOUFFETTE_TRACE_SCOPE("image", "decode tile pyramid");
+        QImageReader reader(path);
+        reader.setAutoTransform(false);
+        QImage level = reader.read();
+        QHash<quint64, QImage> tiles;
+        QString error;
+        if (level.isNull()) {
+            error = reader.errorString();
+        } else {
+            level.convertTo(level.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32);
+            // Halving with rounding up gives exactly levelSize() at every level
+            for (int l = 0; l < levelCount && !level.isNull(); ++l) {
+                for (int y = 0; y < level.height(); y += TileSizePx) {
+                    for (int x = 0; x < level.width(); x += TileSizePx) {
+                        tiles.insert(tileKey(l, x / TileSizePx, y / TileSizePx),
+                                     level.copy(x, y, std::min(TileSizePx, level.width() - x), std::min(TileSizePx, level.height() - y)));
+                    }
+                }
+                if (l + 1 < levelCount) {
+                    level = level.scaled((level.width() + 1) / 2, (level.height() + 1) / 2, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+                }
+            }
+        }
+        QMetaObject::invokeMethod(qApp, [self, tiles = std::move(tiles), error]() mutable {
+            if (self) self->onPyramidDecoded(std::move(tiles), error);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void TiledImageSource::onPyramidDecoded(QHash<quint64, QImage> tiles, const QString& errorString)
+{
+    if (tiles.isEmpty()) {
+        // Not retried: every paint would queue another full decode
+        qWarning() << "TiledImageSource: cannot decode" << m_path << errorString;
+        m_pyramidState = PyramidState::Failed;
+        return;
+    }
+    m_pyramidTiles = std::move(tiles);
+    m_pyramidBytes = 0;
+    for (const QImage& img : std::as_const(m_pyramidTiles)) m_pyramidBytes += img.sizeInBytes();
+    m_pyramidState = PyramidState::Ready;
+    // The coarsest tile covers the whole image: one repaint for everything
+    emit tileReady(m_levelCount - 1, 0, 0);
+}
+
+void TiledImageSource::setCacheLimitBytes(qint64 bytes)
+{
+    m_cache.setMaxCost(static_cast<qsizetype>(std::max<qint64>(0, bytes)));
+}
+
+qint64 TiledImageSource::trimCache()
+{
+    const qint64 before = cachedBytes();
+    const int coarsest = m_levelCount - 1;
+    const QList<quint64> keys = m_cache.keys();
+    for (quint64 key : keys) {
+        if (static_cast<int>(key >> 56) != coarsest) m_cache.remove(key);
+    }
+    if (m_pyramidState == PyramidState::Ready) {
+        // Keep the coarsest tile as placeholder; the pyramid is decoded again when needed
+        const quint64 coarsestKey = tileKey(coarsest, 0, 0);
+        insertTile(coarsest, 0, 0, m_pyramidTiles.value(coarsestKey));
+        m_pyramidTiles.clear();
+        m_pyramidBytes = 0;
+        m_pyramidState = PyramidState::None;
+    }
+    return before - cachedBytes();
+}
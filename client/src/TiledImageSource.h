@@ -0,0 +1,94 @@
+#ifndef TILEDIMAGESOURCE_H
+#define TILEDIMAGESOURCE_H
+
+#include <QObject>
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QRect>
+#include <QSet>
+#include <QSize>
+#include <QString>
+#include <memory>
+
+/**
+ * Lazily decoded, tiled view of a (very large) image file.
+ *
+ * Level 0 is full resolution and every next level halves it, down to a single tile.
+ * When the format reads clip rects and scaled sizes natively (JPEG), tiles are decoded on
+ * a small dedicated thread pool with QImageReader clip + scaled reads, so only the pixels a
+ * tile needs are decoded, and are kept in an LRU cache with a byte cap. Requests that are
+ * no longer painted by the time a worker picks them up are skipped. Other formats (PNG,
+ * GIF...) would decode the whole file for every tile: they are decoded once instead and
+ * cut into a tile pyramid, which trimCache() drops until the next request.
+ * Tiles that failed to decode are not retried.
+ *
+ * GUI thread only; tileReady() is delivered on the GUI thread.
+ */
+class TiledImageSource : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int TileSizePx = 512;
+
+    explicit TiledImageSource(const QString& path, QObject* parent = nullptr);
+    ~TiledImageSource() override;
+
+    bool isValid() const { return !m_fullSize.isEmpty(); }
+    QString path() const { return m_path; }
+    QSize fullSize() const { return m_fullSize; }
+    int levelCount() const { return m_levelCount; }
+    QSize levelSize(int level) const;
+    // Number of tile columns x rows of a level
+    QSize tileGrid(int level) const;
+    // Tile rect in the level's pixel coordinates (edge tiles are smaller)
+    QRect tileRect(int level, int col, int row) const;
+    // Coarsest level still at least as sharp as the given device scale
+    // (device pixels per full-resolution pixel)
+    int levelForScale(qreal scale) const;
+
+    // Marks the start of a paint pass; tiles not requested for a couple of passes are
+    // dropped from the decode queue
+    void beginFrame();
+    // Cached tile, or a null image after queueing an asynchronous decode (deduplicated)
+    QImage tile(int level, int col, int row);
+    // Cached tile only; never schedules a decode
+    QImage cachedTile(int level, int col, int row) const;
+    // Pre-fill the cache with a tile decoded earlier (e.g. restored from a scene snapshot)
+    void insertTile(int level, int col, int row, const QImage& image);
+
+    qint64 cachedBytes() const { return m_cache.totalCost() + m_pyramidBytes; }
+    void setCacheLimitBytes(qint64 bytes);
+    // Drop every cached tile except the coarsest level; returns the bytes freed
+    qint64 trimCache();
+
+signals:
+    void tileReady(int level, int col, int row);
+
+private:
+    struct SharedState;
+
+    enum class PyramidState { None, Decoding, Ready, Failed };
+
+    static quint64 tileKey(int level, int col, int row);
+    // `failed`: the read itself failed (not skipped as stale)
+    void onTileDecoded(quint64 key, int level, int col, int row, const QImage& image, bool failed);
+    void decodePyramidAsync();
+    void onPyramidDecoded(QHash<quint64, QImage> tiles, const QString& errorString);
+
+    QString m_path;
+    QSize m_fullSize;
+    int m_levelCount = 0;
+    QCache<quint64, QImage> m_cache; // cost in bytes
+    QSet<quint64> m_pending;
+    QSet<quint64> m_failed;
+    // Clip + scaled reads are native: decode tile by tile; otherwise through the pyramid
+    bool m_regionReads = false;
+    PyramidState m_pyramidState = PyramidState::None;
+    QHash<quint64, QImage> m_pyramidTiles;
+    qint64 m_pyramidBytes = 0;
+    // Request bookkeeping shared with decode jobs (outlives this object while jobs run)
+    std::shared_ptr<SharedState> m_shared;
+};
+
+#endif // TILEDIMAGESOURCE_H
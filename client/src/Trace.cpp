@@ -0,0 +1,179 @@
+#include "Trace.h"
+#include <QCoreApplication>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+#include <QTextStream>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace {
+// Per thread; 32 bytes per event
+constexpr quint64 kEventsPerThread = 32768;
+// Entries this close to the writer may be overwritten while they are exported
+constexpr quint64 kExportSlack = 256;
+
+struct Event {
+    const char* category;
+    const char* name;
+    qint64 ns;
+    char phase;
+};
+
+struct ThreadBuffer {
+    int tid = 0;
+    QString name;
+    std::vector<Event> events = std::vector<Event>(kEventsPerThread);
+    std::atomic<quint64> written{0};
+};
+
+// Buffers of finished threads kept for the export; past that, new threads recycle the oldest
+// (pool threads come and go, and each buffer is 1 MB)
+constexpr size_t kFinishedBuffersKept = 8;
+
+struct Registry {
+    QMutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    // Finished buffers, oldest first
+    std::deque<std::shared_ptr<ThreadBuffer>> finished;
+    int nextTid = 1;
+};
+
+Registry& registry()
+{
+    static Registry s_registry;
+    return s_registry;
+}
+
+const std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+
+qint64 nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_epoch).count();
+}
+
+std::shared_ptr<ThreadBuffer> acquireBuffer()
+{
+    QString name;
+    QThread* thread = QThread::currentThread();
+    if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+        name = QStringLiteral("GUI");
+    } else if (thread && !thread->objectName().isEmpty()) {
+        name = thread->objectName();
+    }
+    Registry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    std::shared_ptr<ThreadBuffer> buffer;
+    if (reg.finished.size() >= kFinishedBuffersKept) {
+        // The oldest finished thread's spans are dropped from the export
+        buffer = std::move(reg.finished.front());
+        reg.finished.pop_front();
+        buffer->written.store(0, std::memory_order_release);
+    } else {
+        buffer = std::make_shared<ThreadBuffer>();
+        reg.buffers.push_back(buffer);
+    }
+    buffer->tid = reg.nextTid++;
+    buffer->name = name.isEmpty() ? QStringLiteral("Thread %1").arg(buffer->tid) : name;
+    return buffer;
+}
+
+// Hands the buffer back when its thread exits
+struct ThreadBufferHandle {
+    std::shared_ptr<ThreadBuffer> buffer;
+    ~ThreadBufferHandle()
+    {
+        if (!buffer) return;
+        Registry& reg = registry();
+        QMutexLocker locker(&reg.mutex);
+        reg.finished.push_back(std::move(buffer));
+    }
+};
+
+ThreadBuffer* threadBuffer()
+{
+    thread_local ThreadBufferHandle t_handle;
+    if (!t_handle.buffer) t_handle.buffer = acquireBuffer();
+    return t_handle.buffer.get();
+}
+
+void record(const char* category, const char* name, char phase)
+{
+    ThreadBuffer* b = threadBuffer();
+    const quint64 i = b->written.load(std::memory_order_relaxed);
+    b->events[i % kEventsPerThread] = Event{category, name, nowNs(), phase};
+    b->written.store(i + 1, std::memory_order_release);
+}
+}
+
+void Trace::begin(const char* category, const char* name)
+{
+    record(category, name, 'B');
+}
+
+void Trace::end(const char* category, const char* name)
+{
+    record(category, name, 'E');
+}
+
+bool Trace::writeChromeJson(const QString& path, QString* errorString)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (errorString) *errorString = file.errorString();
+        return false;
+    }
+    const qint64 pid = QCoreApplication::applicationPid();
+    QTextStream out(&file);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&]() -> QTextStream& {
+        if (!first) out << ",\n";
+        first = false;
+        return out;
+    };
+
+    struct Snapshot {
+        std::shared_ptr<ThreadBuffer> buffer;
+        int tid;
+        QString name;
+    };
+    std::vector<Snapshot> snapshots;
+    {
+        QMutexLocker locker(&registry().mutex);
+        for (const auto& b : registry().buffers) snapshots.push_back({b, b->tid, b->name});
+    }
+    for (const Snapshot& s : snapshots) {
+        const ThreadBuffer* b = s.buffer.get();
+        separator() << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << pid << ",\"tid\":" << s.tid
+                    << ",\"args\":{\"name\":\"" << QString(s.name).replace('"', '\'') << "\"}}";
+        const quint64 written = b->written.load(std::memory_order_acquire);
+        const quint64 keep = kEventsPerThread - kExportSlack;
+        const quint64 start = written > keep ? written - keep : 0;
+        // The ring may start in the middle of a span: skip ends without a matching begin
+        int depth = 0;
+        for (quint64 i = start; i < written; ++i) {
+            const Event e = b->events[i % kEventsPerThread];
+            if (e.phase == 'E') {
+                if (depth == 0) continue;
+                --depth;
+            } else {
+                ++depth;
+            }
+            separator() << "{\"ph\":\"" << e.phase << "\",\"cat\":\"" << e.category << "\",\"name\":\"" << e.name
+                        << "\",\"ts\":" << QString::number(e.ns / 1000.0, 'f', 3)
+                        << ",\"pid\":" << pid << ",\"tid\":" << s.tid << "}";
+        }
+    }
+    out << "\n]}\n";
+    out.flush();
+    if (!file.commit()) {
+        if (errorString) *errorString = file.errorString();
+        return false;
+    }
+    return true;
+}
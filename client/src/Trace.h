@@ -0,0 +1,45 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QString>
+
+/**
+ * Flight recorder for pipeline spans (demux, decode, convert, paint, network...).
+ *
+ * Every thread records begin/end events into its own fixed-size ring buffer: no locks and no
+ * allocation on the hot path, the oldest events are overwritten. Buffers of finished threads are
+ * kept for a while, then recycled by new threads. writeChromeJson() dumps what is currently
+ * buffered as Chrome/Perfetto trace-event JSON (chrome://tracing, ui.perfetto.dev).
+ *
+ * Instrument with MOUFFETTE_TRACE_SCOPE("category", "name"); both must be string literals.
+ * The macro compiles to nothing unless the build enables MOUFFETTE_ENABLE_TRACING.
+ */
+class Trace {
+public:
+    static void begin(const char* category, const char* name);
+    static void end(const char* category, const char* name);
+    // Best effort while other threads keep recording; returns false on I/O errors
+    static bool writeChromeJson(const QString& path, QString* errorString = nullptr);
+
+    class Scope {
+    public:
+        Scope(const char* category, const char* name) : m_category(category), m_name(name) { begin(category, name); }
+        ~Scope() { end(m_category, m_name); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        const char* m_category;
+        const char* m_name;
+    };
+};
+
+#ifdef MOUFFETTE_TRACING
+#define MOUFFETTE_TRACE_CONCAT_INNER(a, b) a##b
+#define MOUFFETTE_TRACE_CONCAT(a, b) MOUFFETTE_TRACE_CONCAT_INNER(a, b)
+#define MOUFFETTE_TRACE_SCOPE(category, name) \
+    const Trace::Scope MOUFFETTE_TRACE_CONCAT(traceScope_, __LINE__)(category, name)
+#else
+#define MOUFFETTE_TRACE_SCOPE(category, name) do {} while (false)
+#endif
+
+#endif // TRACE_H
@@ -1,4 +1,6 @@
 #include "WebSocketClient.h"
+#include "Trace.h"
+#include "Log.h"
 #include <QJsonArray>
 #include <QDebug>
 
@@ -11,6 +13,7 @@ WebSocketClient::WebSocketClient(QObject *parent)
 {
     m_reconnectTimer->setSingleShot(true);
     connect(m_reconnectTimer, &QTimer::timeout, this, &WebSocketClient::attemptReconnect);
+    m_cursorClock.start();
 }
 
 WebSocketClient::~WebSocketClient() {
@@ -37,7 +40,7 @@ void WebSocketClient::connectToServer(const QString& serverUrl) {
     connect(m_webSocket, &QWebSocket::errorOccurred, this, &WebSocketClient::onError);
     
     setConnectionStatus("Connecting...");
-    qDebug() << "Connecting to server:" << serverUrl;
+    MOUFFETTE_LOG_DEBUG(logNetwork) << "Connecting to server:" << serverUrl;
     m_webSocket->open(QUrl(serverUrl));
 }
 
@@ -78,7 +81,7 @@ void WebSocketClient::registerClient(const QString& machineName, const QString&
     }
     
     sendMessage(message);
-    qDebug() << "Registering client:" << machineName << "(" << platform << ")";
+    MOUFFETTE_LOG_DEBUG(logNetwork) << "Registering client:" << machineName << "(" << platform << ")";
 }
 
 void WebSocketClient::requestClientList() {
@@ -144,11 +147,12 @@ void WebSocketClient::sendCursorUpdate(int globalX, int globalY) {
     msg["type"] = "cursor_update";
     msg["x"] = globalX;
     msg["y"] = globalY;
+    msg["t"] = static_cast<double>(m_cursorClock.elapsed());
     sendMessage(msg);
 }
 
 void WebSocketClient::onConnected() {
-    qDebug() << "Connected to server";
+    MOUFFETTE_LOG_DEBUG(logNetwork) << "Connected to server";
     setConnectionStatus("Connected");
     // Clear user-initiated flag upon successful connection
     m_userInitiatedDisconnect = false;
@@ -158,7 +162,7 @@ void WebSocketClient::onConnected() {
 }
 
 void WebSocketClient::onDisconnected() {
-    qDebug() << "Disconnected from server";
+    MOUFFETTE_LOG_DEBUG(logNetwork) << "Disconnected from server";
     // If user initiated, keep status as Disconnected (no error, no reconnect)
     setConnectionStatus("Disconnected");
     emit disconnected();
@@ -177,8 +181,13 @@ void WebSocketClient::onDisconnected() {
 }
 
 void WebSocketClient::onTextMessageReceived(const QString& message) {
+    MOUFFETTE_TRACE_SCOPE("network", "receive");
     QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8(), &error);
+    QJsonDocument doc;
+    {
+        MOUFFETTE_TRACE_SCOPE("network", "parse json");
+        doc = QJsonDocument::fromJson(message.toUtf8(), &error);
+    }
     
     if (error.error != QJsonParseError::NoError) {
         qWarning() << "Failed to parse JSON message:" << error.errorString();
@@ -209,7 +218,7 @@ void WebSocketClient::onError(QAbstractSocket::SocketError error) {
     }
     // Suppress error status if this is a user-initiated disconnect flow
     if (m_userInitiatedDisconnect) {
-        qDebug() << "Ignoring socket error due to user-initiated disconnect:" << errorString;
+        MOUFFETTE_LOG_DEBUG(logNetwork) << "Ignoring socket error due to user-initiated disconnect:" << errorString;
         return;
     }
     qWarning() << "WebSocket error:" << errorString;
@@ -219,18 +228,18 @@ void WebSocketClient::onError(QAbstractSocket::SocketError error) {
 
 void WebSocketClient::attemptReconnect() {
     if (m_reconnectAttempts <= MAX_RECONNECT_ATTEMPTS) {
-        qDebug() << "Attempting to reconnect..." << m_reconnectAttempts << "/" << MAX_RECONNECT_ATTEMPTS;
+        MOUFFETTE_LOG_DEBUG(logNetwork) << "Attempting to reconnect..." << m_reconnectAttempts << "/" << MAX_RECONNECT_ATTEMPTS;
         connectToServer(m_serverUrl);
     }
 }
 
 void WebSocketClient::handleMessage(const QJsonObject& message) {
     QString type = message["type"].toString();
-    qDebug() << "Received message type:" << type;
+    MOUFFETTE_LOG_TRACE(logNetwork) << "Received message type:" << type;
     
     if (type == "welcome") {
         m_clientId = message["clientId"].toString();
-        qDebug() << "Received client ID:" << m_clientId;
+        MOUFFETTE_LOG_DEBUG(logNetwork) << "Received client ID:" << m_clientId;
     }
     else if (type == "registration_confirmed") {
         QJsonObject clientInfoObj = message["clientInfo"].toObject();
@@ -265,7 +274,9 @@ void WebSocketClient::handleMessage(const QJsonObject& message) {
         const QString targetId = message.value("targetClientId").toString();
         const int x = message.value("x").toInt();
         const int y = message.value("y").toInt();
-        emit cursorPositionReceived(targetId, x, y);
+        const QJsonValue t = message.value("t");
+        const qint64 senderTimeMs = t.isDouble() ? static_cast<qint64>(t.toDouble()) : -1;
+        emit cursorPositionReceived(targetId, x, y, senderTimeMs);
     }
     else {
         // Forward unknown messages
@@ -279,6 +290,7 @@ void WebSocketClient::sendMessage(const QJsonObject& message) {
         return;
     }
     
+    MOUFFETTE_TRACE_SCOPE("network", "send");
     QJsonDocument doc(message);
     QString jsonString = doc.toJson(QJsonDocument::Compact);
     m_webSocket->sendTextMessage(jsonString);
@@ -287,6 +299,6 @@ void WebSocketClient::sendMessage(const QJsonObject& message) {
 void WebSocketClient::setConnectionStatus(const QString& status) {
     if (m_connectionStatus != status) {
         m_connectionStatus = status;
-        qDebug() << "Connection status changed to:" << status;
+        MOUFFETTE_LOG_DEBUG(logNetwork) << "Connection status changed to:" << status;
     }
 }
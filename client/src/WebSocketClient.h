@@ -6,6 +6,7 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QTimer>
+#include <QElapsedTimer>
 #include "ClientInfo.h"
 
 class WebSocketClient : public QObject {
@@ -44,8 +45,9 @@ signals:
     void messageReceived(const QJsonObject& message);
     void watchStatusChanged(bool watched);
     void dataRequestReceived();
-        // Emitted to watchers with remote cursor position of the watched target
-        void cursorPositionReceived(const QString& targetClientId, int x, int y);
+        // Emitted to watchers with remote cursor position of the watched target. senderTimeMs is
+        // the target's monotonic send time (arbitrary base), -1 when the target did not send one.
+        void cursorPositionReceived(const QString& targetClientId, int x, int y, qint64 senderTimeMs);
 
 private slots:
     void onConnected();
@@ -66,6 +68,8 @@ private:
     QTimer* m_reconnectTimer;
     int m_reconnectAttempts;
     bool m_userInitiatedDisconnect = false;
+    // Timestamps outgoing cursor samples; only differences matter to the receiver
+    QElapsedTimer m_cursorClock;
     static const int MAX_RECONNECT_ATTEMPTS = 5;
     static const int RECONNECT_INTERVAL = 3000; // 3 seconds
 };
@@ -3,6 +3,7 @@
 #include <QMessageBox>
 #include "MainWindow.h"
 #include "MacDockHider.h"
+#include "Trace.h"
 
 int main(int argc, char *argv[]) {
     QApplication app(argc, argv);
@@ -18,6 +19,14 @@ int main(int argc, char *argv[]) {
     
     // Don't quit when last window is closed (for tray applications)
     app.setQuitOnLastWindowClosed(false);
+
+#ifdef MOUFFETTE_TRACING
+    // MOUFFETTE_TRACE=<file>: write the trace buffers there on exit
+    const QString tracePath = qEnvironmentVariable("MOUFFETTE_TRACE");
+    if (!tracePath.isEmpty()) {
+        QObject::connect(&app, &QCoreApplication::aboutToQuit, [tracePath]() { Trace::writeChromeJson(tracePath); });
+    }
+#endif
     
     // Check if system tray is available
     if (!QSystemTrayIcon::isSystemTrayAvailable()) {
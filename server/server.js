@@ -322,13 +322,15 @@ class MouffetteServer {
         const x = typeof message.x === 'number' ? Math.round(message.x) : null;
         const y = typeof message.y === 'number' ? Math.round(message.y) : null;
         if (x === null || y === null) return;
+        // Sender timestamp (sender's monotonic ms) lets watchers smooth out network jitter
+        const t = typeof message.t === 'number' ? message.t : undefined;
         for (const watcherId of watchers) {
             const watcher = this.clients.get(watcherId);
             if (!watcher || !watcher.ws) continue;
             watcher.ws.send(JSON.stringify({
                 type: 'cursor_update',
                 targetClientId: targetId,
-                x, y
+                x, y, t
             }));
         }
     }